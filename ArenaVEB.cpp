@@ -0,0 +1,373 @@
+/*
+Arena Van Embe Boas Tree
+
+Same tree and interface as VEB, but every node and every cluster
+array is carved out of an arena instead of being allocated with
+new. Nodes are created lazily, only when a key reaches them, and
+they are never freed one by one. clear() rewinds the arena and
+starts a new empty tree in O(1) without walking the old one, and
+the destructor releases whole chunks, so short-lived scratch sets
+pay almost nothing for allocation and teardown.
+
+The arena can start in a buffer supplied by the caller; it only
+falls back to the heap when that buffer is full.
+
+This code is written in C++.
+Everyone is free to use this code.
+*/
+
+#ifndef __ARENA_VAN_EMBE_BOAS__
+
+#define __ARENA_VAN_EMBE_BOAS__
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+class ArenaVEB {
+
+  public :
+
+    // bump allocator over a list of chunks that are kept on reset
+    class Arena {
+
+      private :
+
+        struct Chunk {
+          char *begin;
+          size_t size;
+          bool owned;
+        };
+
+        vector<Chunk> chunks;
+        size_t cur, used, chunk_size;
+
+        // the arena frees its chunks, so it cannot be copied
+        Arena(const Arena&);
+        Arena& operator=(const Arena&);
+
+      public :
+
+        Arena(void*, size_t, size_t);
+        ~Arena(void);
+        void* allocate(size_t);
+        void reset(void);
+        size_t capacity(void);
+    };
+
+  private:
+
+    static const int error_code = -1;
+
+    struct VEB_NODE {
+
+      int len, half_len;
+      int min, max;
+      VEB_NODE *aux;
+      VEB_NODE **cluster;
+
+      static const int none = -1;
+
+      bool empty(void);
+      int high(int);
+      int low(int);
+      int find_min(void);
+      int find_max(void);
+
+      bool find(int);
+      int successor(int);
+      int predecessor(int);
+      void insert(int, Arena&);
+      void erase(int);
+    };
+
+    static VEB_NODE* new_node(int, Arena&);
+
+    Arena arena;
+    VEB_NODE *head;
+    int bit_len;
+
+    ArenaVEB(const ArenaVEB&);
+    ArenaVEB& operator=(const ArenaVEB&);
+
+  public :
+
+    // list of functions that are accessible
+    ArenaVEB(int, void* = NULL, size_t = 0);
+
+    int size(void);
+    bool empty(void);
+    int error(void);
+    int min(void);
+    int max(void);
+    size_t memory(void);
+
+    bool find(int);
+    int successor(int);
+    int predecessor(int);
+    void insert(int);
+    void erase(int);
+    void clear(void);
+
+};
+
+// arena
+
+ArenaVEB::Arena::Arena(void* buffer, size_t bytes, size_t _chunk_size) : cur(0), used(0), chunk_size(_chunk_size) {
+  if(buffer != NULL and bytes > 0) {
+    Chunk c = {(char*) buffer, bytes, false};
+    chunks.push_back(c);
+  }
+}
+ArenaVEB::Arena::~Arena(void) {
+  for(int i = 0;i < chunks.size();i++) {
+    if(chunks[i].owned) delete[] chunks[i].begin;
+  }
+}
+
+void* ArenaVEB::Arena::allocate(size_t bytes) {
+  const size_t align = alignof(max_align_t);
+  for(;;cur++, used = 0) {
+    if(cur == chunks.size()) {
+      size_t sz = std::max(chunk_size, bytes);
+      Chunk c = {new char[sz], sz, true};
+      chunks.push_back(c);
+    }
+    size_t base = (size_t) chunks[cur].begin;
+    size_t start = (base + used + align - 1) / align * align - base;
+    if(start + bytes <= chunks[cur].size) {
+      used = start + bytes;
+      return chunks[cur].begin + start;
+    }
+  }
+}
+
+// forget every allocation, the chunks are reused from the first one
+void ArenaVEB::Arena::reset(void) {
+  cur = 0;
+  used = 0;
+}
+
+size_t ArenaVEB::Arena::capacity(void) {
+  size_t total = 0;
+  for(int i = 0;i < chunks.size();i++) {
+    total += chunks[i].size;
+  }
+  return total;
+}
+
+// tree nodes
+
+ArenaVEB::VEB_NODE* ArenaVEB::new_node(int len, Arena& arena) {
+  VEB_NODE *p = (VEB_NODE*) arena.allocate(sizeof(VEB_NODE));
+  p->len = len;
+  p->half_len = (len >> 1);
+  p->min = p->max = VEB_NODE::none;
+  p->aux = NULL;
+  p->cluster = NULL;
+  return p;
+}
+
+bool ArenaVEB::VEB_NODE::empty(void) {
+  return min == none;
+}
+int ArenaVEB::VEB_NODE::high(int val) {
+  return val >> half_len;
+}
+int ArenaVEB::VEB_NODE::low(int val) {
+  return val & ((1 << half_len)-1);
+}
+int ArenaVEB::VEB_NODE::find_min(void) {
+  return min;
+}
+int ArenaVEB::VEB_NODE::find_max(void) {
+  if(max == none) return min;
+  return max;
+}
+
+bool ArenaVEB::VEB_NODE::find(int val) {
+  if(val < 0 or val >= (1 << len)) return false;
+  if(min == val or (max != none and val == max)) return true;
+  if(len == 1 or cluster == NULL or max == none) return false;
+  VEB_NODE *c = cluster[high(val)];
+  return c != NULL and c->find(low(val));
+}
+
+int ArenaVEB::VEB_NODE::successor(int val) {
+  if(empty()) return none;
+  if(val < min) return min;
+  if(max == none or val >= max) return none;
+  if(len == 1) return max;
+  int cluster_id = high(val);
+  VEB_NODE *c = cluster[cluster_id];
+  if(c != NULL and !c->empty() and low(val) < c->find_max()) {
+    return (cluster_id << half_len) ^ c->successor(low(val));
+  }
+  int new_cluster_id = aux->successor(cluster_id);
+  if(new_cluster_id == none) return none;
+  return (new_cluster_id << half_len) ^ cluster[new_cluster_id]->find_min();
+}
+
+int ArenaVEB::VEB_NODE::predecessor(int val) {
+  if(empty() or val <= min) return none;
+  if(max == none) return min;
+  if(val > max) return max;
+  if(len == 1) return min;
+  int cluster_id = high(val);
+  VEB_NODE *c = cluster[cluster_id];
+  if(c != NULL and !c->empty() and low(val) > c->find_min()) {
+    return (cluster_id << half_len) ^ c->predecessor(low(val));
+  }
+  int new_cluster_id = aux->predecessor(cluster_id);
+  if(new_cluster_id == none) return min;
+  return (new_cluster_id << half_len) ^ cluster[new_cluster_id]->find_max();
+}
+
+void ArenaVEB::VEB_NODE::insert(int val, Arena& arena) {
+
+  // check for out of bound numbers
+  if(val < 0 or val >= (1 << len)) return;
+
+  if(min == none) {
+    min = val;
+    return;
+  }
+
+  if(val == min) return;
+
+  if(val < min) {
+    swap(min, val);
+  }
+
+  if(val > max or max == none) {
+    max = val;
+  }
+
+  if(len == 1) {
+    return;
+  }
+
+  // the summary and the cluster array are created on first use
+  if(aux == NULL) {
+    aux = new_node(len - half_len, arena);
+    size_t bytes = sizeof(VEB_NODE*) << (len - half_len);
+    cluster = (VEB_NODE**) arena.allocate(bytes);
+    memset(cluster, 0, bytes);
+  }
+
+  int cluster_id = high(val);
+  if(cluster[cluster_id] == NULL) {
+    cluster[cluster_id] = new_node(half_len, arena);
+  }
+  if(cluster[cluster_id]->empty()) {
+    aux->insert(cluster_id, arena);
+  }
+  cluster[cluster_id]->insert(low(val), arena);
+
+}
+
+void ArenaVEB::VEB_NODE::erase(int val) {
+
+  // check for out of bound numbers
+  if(val < 0 or val >= (1 << len)) return;
+
+  // check wheather tree is empty
+  if(empty()) return;
+
+  if(len == 1) {
+    if(val == max) {
+      max = none;
+    }else if(val == min) {
+      min = max;
+      max = none;
+    }
+    return;
+  }
+
+  if(val == min) {
+    if(aux == NULL or aux->empty() or max == none) {
+      min = none;
+    }else {
+      int cluster_id = aux->find_min();
+      min = (cluster_id << half_len) ^ cluster[cluster_id]->find_min();
+      cluster[cluster_id]->erase(low(min));
+      if(cluster[cluster_id]->empty()) {
+        aux->erase(cluster_id);
+      }
+      if(min == max) max = none;
+    }
+    return;
+  }
+
+  if(aux == NULL or aux->empty() or max == none) return;
+
+  int cluster_id = high(val);
+  if(cluster[cluster_id] == NULL) return;
+  cluster[cluster_id]->erase(low(val));
+  if(cluster[cluster_id]->empty()) {
+    aux->erase(cluster_id);
+  }
+  if(val == max) {
+    cluster_id = aux->find_max();
+    if(cluster_id == none) {
+      max = none;
+    }else {
+      max = (cluster_id << half_len) ^ cluster[cluster_id]->find_max();
+    }
+  }
+}
+
+// these functions are publicly accessable
+ArenaVEB::ArenaVEB(int _len, void* buffer, size_t bytes) : arena(buffer, bytes, 1 << 16) {
+  bit_len = _len;
+  head = new_node(bit_len, arena);
+}
+int ArenaVEB::size(void) {
+  return 1 << bit_len;
+}
+bool ArenaVEB::empty(void) {
+  return head->empty();
+}
+int ArenaVEB::error(void) {
+  return error_code;
+}
+int ArenaVEB::min(void) {
+  if(head->find_min() == VEB_NODE::none) return error();
+  return head->find_min();
+}
+int ArenaVEB::max(void) {
+  if(head->find_max() == VEB_NODE::none) return error();
+  return head->find_max();
+}
+// bytes reserved by the arena, including the caller's buffer
+size_t ArenaVEB::memory(void) {
+  return arena.capacity();
+}
+bool ArenaVEB::find(int val) {
+  return head->find(val);
+}
+int ArenaVEB::successor(int val) {
+  int ans = head->successor(val);
+  if(ans == VEB_NODE::none) return error();
+  return ans;
+}
+int ArenaVEB::predecessor(int val) {
+  int ans = head->predecessor(val);
+  if(ans == VEB_NODE::none) return error();
+  return ans;
+}
+void ArenaVEB::insert(int val) {
+  head->insert(val, arena);
+}
+void ArenaVEB::erase(int val) {
+  head->erase(val);
+}
+void ArenaVEB::clear(void) {
+  arena.reset();
+  head = new_node(bit_len, arena);
+}
+
+#endif
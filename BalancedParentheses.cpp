@@ -0,0 +1,273 @@
+/*
+Balanced Parentheses
+
+A bit sequence of '(' (1) and ')' (0) with O(1) rank, near O(1)
+select and range minimum excess queries. The sequence of n pairs
+takes 2n bits and the directories about (272 + 32 log2(n / 256)) / 256
+bits per pair, 2.6 at n = 2^20 and 3.3 at n = 2^26. The sparse table
+over the blocks grows with log n, so with a fixed block size this is
+not o(n), only a small constant per pair at these sizes.
+
+excess(p) is the number of '(' minus the number of ')' among the
+first p symbols, so positions go from 0 to size() inclusive.
+
+Directories :
+- rank of every 512-bit superblock and of every word inside it
+- the superblock of every 4096-th '(' to narrow down select
+- minimum excess of every 512-position block and a sparse table
+  over those minimums for range minimum excess
+
+This code is for C++11 or newer version
+*/
+
+#ifndef __MYLIB__BALANCED_PARENTHESES__
+
+#define __MYLIB__BALANCED_PARENTHESES__
+
+#include "MyMath.cpp"
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+class BalancedParentheses {
+
+	public:
+
+		BalancedParentheses(void);
+
+		void reserve(long long);
+		void push(bool);
+		void build(void);
+
+		long long size(void) const;
+		long long memory(void) const;
+
+		long long rank_open(long long) const;
+		long long select_open(long long) const;
+		long long excess(long long) const;
+		long long rmq_excess(long long, long long) const;
+
+	private:
+
+		static const int WORD = 64;
+		static const int BLOCK = 512;
+		static const int SAMPLE = 4096;
+
+		// minimum prefix excess of a byte and the last position reaching it
+		struct ByteTable {
+			signed char delta[256], low[256], pos[256];
+			ByteTable(void);
+		};
+		static const ByteTable& table(void);
+
+		bool bit(long long) const;
+		void scan(long long, long long, long long&, long long&) const;
+
+		long long len;
+		vector<unsigned long long> bits;
+		vector<long long> super_rank;
+		vector<unsigned short> word_rank;
+		vector<int> sample;
+
+		vector<int> block_min;
+		vector<unsigned short> block_pos;
+		vector< vector<int> > block_table;
+};
+
+BalancedParentheses::ByteTable::ByteTable(void) {
+	for(int v = 0;v < 256;v++) {
+		int e = 0;
+		low[v] = 8, pos[v] = 0;
+		for(int k = 0;k < 8;k++) {
+			e += (v >> k & 1) ? 1 : -1;
+			if(e <= low[v]) {
+				low[v] = e;
+				pos[v] = k + 1;
+			}
+		}
+		delta[v] = e;
+	}
+}
+
+const BalancedParentheses::ByteTable& BalancedParentheses::table(void) {
+	static const ByteTable T;
+	return T;
+}
+
+BalancedParentheses::BalancedParentheses(void) : len(0) {}
+
+// room for n symbols, so that push never reallocates
+void BalancedParentheses::reserve(long long n) {
+	bits.reserve(n / WORD + 1);
+}
+
+void BalancedParentheses::push(bool open) {
+	if(len % WORD == 0) bits.push_back(0);
+	if(open) bits.back() |= 1ULL << (len % WORD);
+	len++;
+}
+
+bool BalancedParentheses::bit(long long p) const {
+	return bits[p / WORD] >> (p % WORD) & 1;
+}
+
+long long BalancedParentheses::size(void) const {
+	return len;
+}
+
+// size of the sequence and every directory in bytes
+long long BalancedParentheses::memory(void) const {
+	long long total = bits.size() * sizeof(unsigned long long) + super_rank.size() * sizeof(long long)
+		+ word_rank.size() * sizeof(unsigned short) + sample.size() * sizeof(int)
+		+ block_min.size() * sizeof(int) + block_pos.size() * sizeof(unsigned short);
+	for(int i = 0;i < block_table.size();i++) {
+		total += block_table[i].size() * sizeof(int);
+	}
+	return total;
+}
+
+void BalancedParentheses::build(void) {
+
+	// rank directories, one spare word so that rank_open(len) is defined
+	bits.resize(len / WORD + 1, 0);
+	super_rank.assign(len / BLOCK + 2, 0);
+	word_rank.assign(bits.size(), 0);
+	sample.clear();
+
+	long long ones = 0;
+	for(long long w = 0;w < bits.size();w++) {
+		if(w % (BLOCK / WORD) == 0) {
+			super_rank[w / (BLOCK / WORD)] = ones;
+		}
+		word_rank[w] = ones - super_rank[w / (BLOCK / WORD)];
+		long long c = __builtin_popcountll(bits[w]);
+		while((long long) sample.size() * SAMPLE < ones + c) {
+			sample.push_back(w / (BLOCK / WORD));
+		}
+		ones += c;
+	}
+	for(long long s = (bits.size() + BLOCK / WORD - 1) / (BLOCK / WORD);s < super_rank.size();s++) {
+		super_rank[s] = ones;
+	}
+	sample.push_back(super_rank.size() - 1);
+
+	// minimum excess of every block of positions, ties to the right
+	long long blocks = len / BLOCK + 1;
+	block_min.assign(blocks, 0);
+	block_pos.assign(blocks, 0);
+	long long e = 0;
+	for(long long p = 0;p <= len;p++) {
+		if(p % BLOCK == 0 or e <= block_min[p / BLOCK]) {
+			block_min[p / BLOCK] = e;
+			block_pos[p / BLOCK] = p % BLOCK;
+		}
+		if(p < len) e += bit(p) ? 1 : -1;
+	}
+
+	block_table.assign(MyMath::log2((int) blocks) + 1, vector<int>(blocks, 0));
+	for(int j = 0;j < blocks;j++) {
+		block_table[0][j] = j;
+	}
+	for(int i = 1;i < block_table.size();i++) {
+		for(int j = 0;j < blocks;j++) {
+			int x = block_table[i-1][j];
+			int y = block_table[i-1][min(blocks-1, j + (1LL << (i-1)))];
+			block_table[i][j] = block_min[y] <= block_min[x] ? y : x;
+		}
+	}
+}
+
+// number of '(' among the first p symbols
+long long BalancedParentheses::rank_open(long long p) const {
+	long long w = p / WORD;
+	unsigned long long m = (p % WORD == 0) ? 0 : bits[w] & (~0ULL >> (WORD - p % WORD));
+	return super_rank[p / BLOCK] + word_rank[w] + __builtin_popcountll(m);
+}
+
+// position of the k-th '(' (0-based), or -1
+long long BalancedParentheses::select_open(long long k) const {
+	if(k < 0 or k >= super_rank.back()) return -1;
+
+	// the sample brackets the superblock, then binary search inside
+	long long lo = sample[k / SAMPLE], hi = sample[k / SAMPLE + 1];
+	lo = upper_bound(super_rank.begin() + lo, super_rank.begin() + hi + 1, k) - super_rank.begin() - 1;
+
+	k -= super_rank[lo];
+	long long w = lo * (BLOCK / WORD);
+	while(w + 1 < bits.size() and (w + 1) % (BLOCK / WORD) != 0 and word_rank[w + 1] <= k) {
+		w++;
+	}
+	k -= word_rank[w];
+
+	unsigned long long x = bits[w];
+	int offset = 0;
+	while(__builtin_popcountll(x & 0xFF) <= k) {
+		k -= __builtin_popcountll(x & 0xFF);
+		x >>= 8;
+		offset += 8;
+	}
+	while(k > 0) {
+		x &= x - 1;
+		k--;
+	}
+	return w * WORD + offset + __builtin_ctzll(x);
+}
+
+long long BalancedParentheses::excess(long long p) const {
+	return 2 * rank_open(p) - p;
+}
+
+// minimum excess on [lo, hi] inside a single block, ties to the right
+void BalancedParentheses::scan(long long lo, long long hi, long long& best, long long& where) const {
+	const ByteTable& T = table();
+	long long e = excess(lo);
+	if(e <= best) {
+		best = e;
+		where = lo;
+	}
+	long long p = lo;
+	while(p < hi) {
+		if(p % 8 == 0 and p + 8 <= hi) {
+			int v = bits[p / WORD] >> (p % WORD) & 0xFF;
+			if(e + T.low[v] <= best) {
+				best = e + T.low[v];
+				where = p + T.pos[v];
+			}
+			e += T.delta[v];
+			p += 8;
+		}else {
+			e += bit(p) ? 1 : -1;
+			p++;
+			if(e <= best) {
+				best = e;
+				where = p;
+			}
+		}
+	}
+}
+
+// last position of the minimum excess on [lo, hi]
+long long BalancedParentheses::rmq_excess(long long lo, long long hi) const {
+	long long best = len + 1, where = lo;
+	long long b1 = lo / BLOCK, b2 = hi / BLOCK;
+	if(b1 == b2) {
+		scan(lo, hi, best, where);
+		return where;
+	}
+	scan(lo, b1 * BLOCK + BLOCK - 1, best, where);
+	if(b1 + 1 <= b2 - 1) {
+		int x = MyMath::log2((int) (b2 - b1 - 1));
+		int id1 = block_table[x][b1 + 1];
+		int id2 = block_table[x][b2 - (1 << x)];
+		int id = block_min[id2] <= block_min[id1] ? id2 : id1;
+		if(block_min[id] <= best) {
+			best = block_min[id];
+			where = (long long) id * BLOCK + block_pos[id];
+		}
+	}
+	scan(b2 * BLOCK, hi, best, where);
+	return where;
+}
+
+#endif
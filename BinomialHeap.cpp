@@ -1,141 +1,275 @@
+/*
+Binomial Heap
+
+push returns a handle of the new element, decreasekey takes the
+handle. Keys move between the tree nodes when decreasekey sifts up,
+so a handle points to the node that holds its element and the node
+points back to the handle.
+
+In the default (eager) mode the roots are kept one per degree, so
+push and meld carry like binary addition, O(1) amortized for push
+and O(log n) for meld. In the lazy mode push and meld only add
+roots to a list in O(1), and pop links the list down to one root
+per degree before it removes the minimum.
+
+pop, top and decreasekey take O(log n) in both modes (pop is
+amortized in the lazy mode). Nodes and handles come from a
+NodePool, so pop recycles them and meld takes the other heap's
+nodes without copying, leaving it empty.
+
+The bulk constructor builds a heap of n keys in O(n).
+*/
 
 #ifndef BINOMIAL_HEAP
 
 #define BINOMIAL_HEAP
 
+#include "NodePool.cpp"
 #include <vector>
 
 using namespace std;
 
 template<class Data> class BinomialHeap {
-	
+
 	public :
 
+		class node;
+
 		class iterator {
 
 			public :
-	
-				int id, deg;
+
+				node *pos;
+
+				const Data& key(void) const {
+					return pos->key;
+				}
+		};
+
+		class node {
+
+			public :
+
+				int deg;
 				Data key;
-				iterator *parent, *left, *right, *left_child;
-	
-				iterator(Data k) : key(k), deg(0), parent(NULL), 
-					left(NULL), left_child(NULL), right(NULL) {}
-				~iterator(void) {}
+				iterator *item;
+				node *parent, *right, *left_child;
 		};
 
 		int total_size;
-		vector<iterator*> root;
-		int min_idx;
+		bool lazy;
+
+		// root[d] is the root of degree d in the eager mode, in the lazy
+		// mode the roots are the list linked by right and root is only
+		// used while pop links them
+		vector<node*> root;
+		node *list, *list_tail, *min_node;
+
+		NodePool<node> nodes;
+		NodePool<iterator> items;
 
 		bool empty(void) {
-			return min_idx == -1;
+			return total_size == 0;
 		}
 
 		int size(void) {
 			return total_size;
 		}
 
-		void insert_root(iterator *new_node) {
+		// the root with the larger key becomes the first child of the
+		// other, on a tie the minimum stays a root
+		node* link(node *u, node *v) {
+			if(v->key < u->key or (v == min_node and !(u->key < v->key))) {
+				swap(u, v);
+			}
+			v->parent = u;
+			v->right = u->left_child;
+			u->left_child = v;
+			u->deg++;
+			return u;
+		}
 
+		void insert_root(node *new_node) {
+
+			new_node->parent = new_node->right = NULL;
+
+			while(new_node->deg < root.size() and root[new_node->deg] != NULL) {
+				int d = new_node->deg;
+				new_node = link(new_node, root[d]);
+				root[d] = NULL;
+			}
 			if(new_node->deg >= root.size()) {
 				root.resize(new_node->deg+1, NULL);
 			}
-
-			while(root[new_node->deg] != NULL) {
-				
-				iterator *v = root[new_node->deg];
-				if(v->key < new_node->key) {
-					swap(new_node, v);	
-				}
-				v->parent = new_node;
-				v->left = NULL;
-				v->right = new_node->left_child;
-				if(v->right != NULL) v->right->left = v;
-				new_node->left_child = v;
-				root[new_node->deg++] = NULL;
-
-				if(new_node->deg >= root.size()) {
-					root.resize(new_node->deg+1, NULL);
-				}
-			}
 			root[new_node->deg] = new_node;
-			if(min_idx == -1 or root[min_idx] == NULL or root[new_node->deg]->key < root[min_idx]->key) {
-				min_idx = new_node->deg;
+
+		}
+
+		void insert_list(node *new_node) {
+			new_node->parent = NULL;
+			new_node->right = list;
+			if(list == NULL) list_tail = new_node;
+			list = new_node;
+		}
+
+		void update_min(node *v) {
+			if(min_node == NULL or v->key < min_node->key) {
+				min_node = v;
 			}
+		}
 
+		node* new_node(const Data& new_data) {
+			node *v = nodes.allocate();
+			v->deg = 0;
+			v->key = new_data;
+			v->parent = v->right = v->left_child = NULL;
+			v->item = items.allocate();
+			v->item->pos = v;
+			return v;
 		}
 
 		iterator* push(Data new_data) {
-			iterator *new_node = new iterator(new_data);
-			insert_root(new_node);
+			node *v = new_node(new_data);
+			if(lazy) {
+				insert_list(v);
+			}else {
+				insert_root(v);
+			}
+			update_min(v);
 			total_size++;
-			return new_node;
+			return v->item;
 		}
 
 		void decreasekey(iterator *current, Data new_key) {
-			current->key = new_key;
-			iterator *ancestor = current->parent;
-			while(ancestor != NULL and current->key < ancestor->key) {
-				swap(current->key, ancestor->key);
-				current = current->parent;
-				ancestor = ancestor->parent;
+			node *v = current->pos;
+			v->key = new_key;
+			while(v->parent != NULL and v->key < v->parent->key) {
+				node *p = v->parent;
+				swap(v->key, p->key);
+				swap(v->item, p->item);
+				v->item->pos = v;
+				p->item->pos = p;
+				v = p;
+			}
+			if(v->parent == NULL) {
+				update_min(v);
 			}
 		}
 
 		void pop(void) {
-			
+
 			if(empty()) {
 				return;
 			}
 
-			iterator *v = root[min_idx]->left_child;
+			node *m = min_node;
 
-			root[min_idx] = NULL;
-			delete root[min_idx];
-			root[min_idx] = NULL;
-
-			min_idx = -1;
+			if(lazy) {
+				// every root but the minimum goes into the degree table
+				for(node *v = list;v != NULL;) {
+					node *nxt = v->right;
+					if(v != m) insert_root(v);
+					v = nxt;
+				}
+				list = list_tail = NULL;
+			}else {
+				root[m->deg] = NULL;
+			}
 
-			while(v != NULL) {
-				iterator *nxt = v->right;
-				v->parent = v->left = v->right = NULL;
+			for(node *v = m->left_child;v != NULL;) {
+				node *nxt = v->right;
 				insert_root(v);
 				v = nxt;
 			}
-			
-			int last = 0;
-			min_idx = -1;
+
+			items.release(m->item);
+			nodes.release(m);
+			total_size--;
+
+			int last = -1;
+			min_node = NULL;
 			for(int i = 0;i < root.size();i++) {
 				if(root[i] != NULL) {
-					if(min_idx == -1 or root[i]->key < root[min_idx]->key) {
-						min_idx = i;
+					update_min(root[i]);
+					if(lazy) {
+						insert_list(root[i]);
+						root[i] = NULL;
 					}
 					last = i;
 				}
 			}
 
-			root.resize(last+1, NULL);
-			total_size--;
+			root.resize(lazy ? 0 : last+1);
 		}
 
 		Data top(void) {
-			if(not empty()) {
-				return root[min_idx]->key;
+			if(empty()) {
+				return Data();
 			}
+			return min_node->key;
 		}
 
-		void meld(BinomialHeap<Data> H2) {
-			if(empty()) return H2;
-			if(H2.empty()) return *this;
-			for(int i = 0;i < H2->root.size();i++) {
-				if(H2->root[i] != NULL) {
-					insert_root(H2->root[i]);
+		// move every element of H2 into this heap, H2 becomes empty
+		void meld(BinomialHeap<Data> &H2) {
+			if(&H2 == this or H2.empty()) return;
+			nodes.splice(H2.nodes);
+			items.splice(H2.items);
+			if(lazy and H2.list != NULL) {
+				H2.list_tail->right = list;
+				if(list == NULL) list_tail = H2.list_tail;
+				list = H2.list;
+			}else {
+				for(node *v = H2.list;v != NULL;) {
+					node *nxt = v->right;
+					insert_root(v);
+					v = nxt;
+				}
+			}
+			for(int i = 0;i < H2.root.size();i++) {
+				if(H2.root[i] != NULL) {
+					if(lazy) {
+						insert_list(H2.root[i]);
+					}else {
+						insert_root(H2.root[i]);
+					}
 				}
 			}
+			update_min(H2.min_node);
+			if(!lazy) {
+				// linking may have put the minimum under another root
+				min_node = NULL;
+				for(int i = 0;i < root.size();i++) {
+					if(root[i] != NULL) update_min(root[i]);
+				}
+			}
+			total_size += H2.total_size;
+			H2.root.clear();
+			H2.list = H2.list_tail = H2.min_node = NULL;
+			H2.total_size = 0;
 		}
 
-		BinomialHeap(void) : min_idx(-1), total_size(0) {}
+		BinomialHeap(bool _lazy = false) : total_size(0), lazy(_lazy), list(NULL), list_tail(NULL), min_node(NULL) {}
+
+		// n keys are linked like n increments of a binary counter, O(n)
+		BinomialHeap(const vector<Data> &data, bool _lazy = false) : total_size(0), lazy(false),
+			list(NULL), list_tail(NULL), min_node(NULL) {
+			nodes.reserve(data.size());
+			items.reserve(data.size());
+			for(int i = 0;i < data.size();i++) {
+				insert_root(new_node(data[i]));
+			}
+			total_size = data.size();
+			for(int i = 0;i < root.size();i++) {
+				if(root[i] != NULL) update_min(root[i]);
+			}
+			if(_lazy) {
+				lazy = true;
+				for(int i = 0;i < root.size();i++) {
+					if(root[i] != NULL) insert_list(root[i]);
+				}
+				root.clear();
+			}
+		}
 };
 
-#endif
\ No newline at end of file
+#endif
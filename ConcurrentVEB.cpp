@@ -0,0 +1,389 @@
+/*
+Concurrent Van Embe Boas Tree
+
+Same set operations as FlatVEB, for one writer and many readers.
+Readers never lock and never wait for the writer. Every reader
+works on a snapshot, a fixed version of the tree that later updates
+do not change.
+
+The tree is the FlatVEB layout made persistent: a 64-ary trie
+whose nodes hold a 64-bit mask and only their non-empty children.
+An update copies the O(log U / 6) nodes on the path to its key and
+publishes the new root with one atomic store. Older versions stay
+readable by the snapshots that hold them.
+
+The old nodes are freed with epoch based reclamation. Each reader
+owns a slot. Taking a snapshot writes the current epoch into the
+slot, and releasing it clears the slot. The nodes replaced by an
+update are freed once no slot holds an epoch from before that
+update.
+
+Updates are serialized by a mutex. Each reader id in
+[0, readers) may hold only one snapshot at a time.
+
+This code is for C++11 or newer version, compile with -pthread.
+Everyone is free to use this code.
+*/
+
+#ifndef __CONCURRENT_VAN_EMBE_BOAS__
+
+#define __CONCURRENT_VAN_EMBE_BOAS__
+
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+class ConcurrentVEB {
+
+  private:
+
+    static const int error_code = -1;
+    static const unsigned long long idle = ~0ULL;
+
+    // a leaf has one bit per key, an inner node one bit per
+    // non-empty child and the children in increasing order
+    struct Node {
+      unsigned long long mask;
+      const Node *child[1];
+    };
+
+    // one cache line per reader so that readers do not share lines
+    struct Slot {
+      atomic<unsigned long long> epoch;
+      char pad[64 - sizeof(atomic<unsigned long long>)];
+    };
+
+    int bit_len, levels;
+    atomic<const Node*> root;
+    atomic<unsigned long long> epoch;
+    vector<Slot> slots;
+
+    mutex writer;
+    vector<const Node*> garbage;
+    deque< pair<unsigned long long, vector<const Node*> > > retired;
+
+    static Node* new_node(int);
+    static void free_node(const Node*);
+    static void free_tree(const Node*, int);
+    static int child_count(const Node*);
+    static int child_rank(const Node*, int);
+    static bool has(const Node*, int);
+
+    static int node_min(const Node*, int, int);
+    static int node_max(const Node*, int, int);
+    static bool node_find(const Node*, int, int);
+    static int node_successor(const Node*, int, int, int);
+    static int node_predecessor(const Node*, int, int, int);
+
+    const Node* inserted(const Node*, int, int);
+    const Node* erased(const Node*, int, int);
+    void publish(const Node*);
+    void reclaim(void);
+
+  public :
+
+    // a pinned version of the tree, released by its destructor
+    class Snapshot {
+
+      private :
+
+        ConcurrentVEB *tree;
+        const Node *root;
+        int slot;
+
+        Snapshot(const Snapshot&);
+        Snapshot& operator=(const Snapshot&);
+
+      public :
+
+        Snapshot(ConcurrentVEB*, int);
+        Snapshot(Snapshot&&);
+        ~Snapshot(void);
+
+        bool empty(void);
+        int min(void);
+        int max(void);
+        bool find(int);
+        int successor(int);
+        int predecessor(int);
+    };
+
+    // list of functions that are accessible
+    ConcurrentVEB(int, int = 64);
+    ~ConcurrentVEB(void);
+
+    int size(void);
+    int error(void);
+    int readers(void);
+
+    Snapshot snapshot(int);
+    void insert(int);
+    void erase(int);
+
+};
+
+// nodes
+
+ConcurrentVEB::Node* ConcurrentVEB::new_node(int children) {
+  size_t bytes = sizeof(Node) + (children > 1 ? children - 1 : 0) * sizeof(const Node*);
+  return (Node*) ::operator new(bytes);
+}
+void ConcurrentVEB::free_node(const Node *p) {
+  ::operator delete((void*) p);
+}
+void ConcurrentVEB::free_tree(const Node *p, int level) {
+  if(p == NULL) return;
+  if(level > 0) {
+    for(int i = child_count(p) - 1;i >= 0;i--) {
+      free_tree(p->child[i], level - 1);
+    }
+  }
+  free_node(p);
+}
+int ConcurrentVEB::child_count(const Node *p) {
+  return __builtin_popcountll(p->mask);
+}
+// position of child i among the children that exist
+int ConcurrentVEB::child_rank(const Node *p, int i) {
+  return __builtin_popcountll(p->mask & ((1ULL << i) - 1));
+}
+bool ConcurrentVEB::has(const Node *p, int i) {
+  return p != NULL and (p->mask >> i & 1);
+}
+
+// these work on one version and never write, base is the
+// smallest key of the subtree of p
+
+int ConcurrentVEB::node_min(const Node *p, int level, int base) {
+  for(;level > 0;level--) {
+    base |= __builtin_ctzll(p->mask) << (6 * level);
+    p = p->child[0];
+  }
+  return base | __builtin_ctzll(p->mask);
+}
+int ConcurrentVEB::node_max(const Node *p, int level, int base) {
+  for(;level > 0;level--) {
+    base |= (63 - __builtin_clzll(p->mask)) << (6 * level);
+    p = p->child[child_count(p) - 1];
+  }
+  return base | (63 - __builtin_clzll(p->mask));
+}
+
+bool ConcurrentVEB::node_find(const Node *p, int level, int val) {
+  for(;p != NULL;level--) {
+    int i = (val >> (6 * level)) & 63;
+    if(!has(p, i)) return false;
+    if(level == 0) return true;
+    p = p->child[child_rank(p, i)];
+  }
+  return false;
+}
+
+// smallest key greater than val, val is inside the subtree of p
+int ConcurrentVEB::node_successor(const Node *p, int level, int base, int val) {
+  int i = (val >> (6 * level)) & 63;
+  if(level > 0 and has(p, i)) {
+    int ans = node_successor(p->child[child_rank(p, i)], level - 1, base | (i << (6 * level)), val);
+    if(ans != error_code) return ans;
+  }
+  unsigned long long m = (i == 63 ? 0 : p->mask & (~0ULL << (i + 1)));
+  if(m == 0) return error_code;
+  int j = __builtin_ctzll(m);
+  if(level == 0) return base | j;
+  return node_min(p->child[child_rank(p, j)], level - 1, base | (j << (6 * level)));
+}
+
+// largest key smaller than val, val is inside the subtree of p
+int ConcurrentVEB::node_predecessor(const Node *p, int level, int base, int val) {
+  int i = (val >> (6 * level)) & 63;
+  if(level > 0 and has(p, i)) {
+    int ans = node_predecessor(p->child[child_rank(p, i)], level - 1, base | (i << (6 * level)), val);
+    if(ans != error_code) return ans;
+  }
+  unsigned long long m = p->mask & ((1ULL << i) - 1);
+  if(m == 0) return error_code;
+  int j = 63 - __builtin_clzll(m);
+  if(level == 0) return base | j;
+  return node_max(p->child[child_rank(p, j)], level - 1, base | (j << (6 * level)));
+}
+
+// path copying, the old nodes of the path go to garbage and the
+// node itself is returned when nothing changes
+
+const ConcurrentVEB::Node* ConcurrentVEB::inserted(const Node *p, int level, int val) {
+  int i = (val >> (6 * level)) & 63;
+  if(level == 0) {
+    if(has(p, i)) return p;
+    Node *q = new_node(0);
+    q->mask = (p == NULL ? 0 : p->mask) | (1ULL << i);
+    if(p != NULL) garbage.push_back(p);
+    return q;
+  }
+  const Node *c = has(p, i) ? p->child[child_rank(p, i)] : NULL;
+  const Node *nc = inserted(c, level - 1, val);
+  if(nc == c) return p;
+  int cnt = (p == NULL ? 0 : child_count(p)), r = (p == NULL ? 0 : child_rank(p, i));
+  Node *q = new_node(cnt + (c == NULL));
+  q->mask = (p == NULL ? 0 : p->mask) | (1ULL << i);
+  for(int k = 0;k < r;k++) {
+    q->child[k] = p->child[k];
+  }
+  q->child[r] = nc;
+  for(int k = r + (c != NULL);k < cnt;k++) {
+    q->child[k + (c == NULL)] = p->child[k];
+  }
+  if(p != NULL) garbage.push_back(p);
+  return q;
+}
+
+// returns NULL when the subtree becomes empty
+const ConcurrentVEB::Node* ConcurrentVEB::erased(const Node *p, int level, int val) {
+  int i = (val >> (6 * level)) & 63;
+  if(!has(p, i)) return p;
+  if(level == 0) {
+    garbage.push_back(p);
+    if(p->mask == (1ULL << i)) return NULL;
+    Node *q = new_node(0);
+    q->mask = p->mask & ~(1ULL << i);
+    return q;
+  }
+  int cnt = child_count(p), r = child_rank(p, i);
+  const Node *c = p->child[r];
+  const Node *nc = erased(c, level - 1, val);
+  if(nc == c) return p;
+  garbage.push_back(p);
+  if(nc == NULL and cnt == 1) return NULL;
+  Node *q = new_node(cnt - (nc == NULL));
+  q->mask = (nc == NULL ? p->mask & ~(1ULL << i) : p->mask);
+  for(int k = 0, l = 0;k < cnt;k++) {
+    if(k != r) {
+      q->child[l++] = p->child[k];
+    }else if(nc != NULL) {
+      q->child[l++] = nc;
+    }
+  }
+  return q;
+}
+
+// make the new root visible, then retire the replaced nodes with the
+// epoch they were last visible in
+void ConcurrentVEB::publish(const Node *new_root) {
+  root.store(new_root);
+  if(!garbage.empty()) {
+    retired.push_back(make_pair(epoch.load(), vector<const Node*>()));
+    retired.back().second.swap(garbage);
+    epoch.fetch_add(1);
+  }
+  if(retired.size() >= 64) {
+    reclaim();
+  }
+}
+
+// free every batch retired before the oldest pinned epoch
+void ConcurrentVEB::reclaim(void) {
+  unsigned long long oldest = idle;
+  for(int i = 0;i < slots.size();i++) {
+    unsigned long long e = slots[i].epoch.load();
+    if(e < oldest) oldest = e;
+  }
+  while(!retired.empty() and retired.front().first < oldest) {
+    vector<const Node*> &batch = retired.front().second;
+    for(int i = 0;i < batch.size();i++) {
+      free_node(batch[i]);
+    }
+    retired.pop_front();
+  }
+}
+
+// snapshots
+
+ConcurrentVEB::Snapshot::Snapshot(ConcurrentVEB *_tree, int _slot) : tree(_tree), slot(_slot) {
+  tree->slots[slot].epoch.store(tree->epoch.load());
+  root = tree->root.load();
+}
+ConcurrentVEB::Snapshot::Snapshot(Snapshot&& s) : tree(s.tree), root(s.root), slot(s.slot) {
+  s.tree = NULL;
+}
+ConcurrentVEB::Snapshot::~Snapshot(void) {
+  if(tree != NULL) {
+    tree->slots[slot].epoch.store(idle);
+  }
+}
+
+bool ConcurrentVEB::Snapshot::empty(void) {
+  return root == NULL;
+}
+int ConcurrentVEB::Snapshot::min(void) {
+  if(empty()) return error_code;
+  return node_min(root, tree->levels - 1, 0);
+}
+int ConcurrentVEB::Snapshot::max(void) {
+  if(empty()) return error_code;
+  return node_max(root, tree->levels - 1, 0);
+}
+bool ConcurrentVEB::Snapshot::find(int val) {
+  if(val < 0 or val >= tree->size()) return false;
+  return node_find(root, tree->levels - 1, val);
+}
+int ConcurrentVEB::Snapshot::successor(int val) {
+  if(val < 0) return min();
+  if(empty() or val >= tree->size()) return error_code;
+  return node_successor(root, tree->levels - 1, 0, val);
+}
+int ConcurrentVEB::Snapshot::predecessor(int val) {
+  if(val >= tree->size()) return max();
+  if(empty() or val <= 0) return error_code;
+  return node_predecessor(root, tree->levels - 1, 0, val);
+}
+
+// these functions are publicly accessable
+ConcurrentVEB::ConcurrentVEB(int _len, int _readers) : root(NULL), epoch(0), slots(_readers) {
+  bit_len = _len;
+  levels = (bit_len <= 6 ? 1 : (bit_len + 5) / 6);
+  for(int i = 0;i < slots.size();i++) {
+    slots[i].epoch.store(idle);
+  }
+}
+// no snapshot may be alive when the tree is destroyed
+ConcurrentVEB::~ConcurrentVEB(void) {
+  for(;!retired.empty();retired.pop_front()) {
+    vector<const Node*> &batch = retired.front().second;
+    for(int i = 0;i < batch.size();i++) {
+      free_node(batch[i]);
+    }
+  }
+  free_tree(root.load(), levels - 1);
+}
+int ConcurrentVEB::size(void) {
+  return 1 << bit_len;
+}
+int ConcurrentVEB::error(void) {
+  return error_code;
+}
+int ConcurrentVEB::readers(void) {
+  return slots.size();
+}
+// reader is the slot of the calling thread, in [0, readers())
+ConcurrentVEB::Snapshot ConcurrentVEB::snapshot(int reader) {
+  return Snapshot(this, reader);
+}
+void ConcurrentVEB::insert(int val) {
+  if(val < 0 or val >= size()) return;
+  lock_guard<mutex> lock(writer);
+  const Node *old_root = root.load();
+  const Node *new_root = inserted(old_root, levels - 1, val);
+  if(new_root != old_root) publish(new_root);
+}
+void ConcurrentVEB::erase(int val) {
+  if(val < 0 or val >= size()) return;
+  lock_guard<mutex> lock(writer);
+  const Node *old_root = root.load();
+  const Node *new_root = erased(old_root, levels - 1, val);
+  if(new_root != old_root) publish(new_root);
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+Disjoint Sparse Table
+
+Problem :
+input A1, A2, ..., An and an associative operation *
+each query return Ai * Ai+1 * ... * Aj
+
+Unlike RMQ, the operation does not have to be idempotent
+(sum, product, matrix product, ...). Level h splits the array
+into blocks of 2^h and stores, for every index, the product from
+the index to the middle of its block, so any range is covered by
+exactly two precomputed parts that do not overlap.
+
+This algorithm requires O(n log n) precomputation and memmory
+and answers each query with exactly one operation.
+
+This code is for C++11 or newer version
+*/
+
+#ifndef __MYLIB__DISJOINT_SPARSE_TABLE__
+
+#define __MYLIB__DISJOINT_SPARSE_TABLE__
+
+#include "MyMath.cpp"
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+template<class Data, class Operation = plus<Data> > class DisjointSparseTable {
+
+	public:
+
+		DisjointSparseTable(const vector<Data>&, const Operation& = Operation());
+		DisjointSparseTable(void);
+
+		int size(void) const;
+		Data query(int, int) const;
+		const Data& operator[](int) const;
+
+	private:
+
+		int n, levels;
+		mutable Operation op;
+
+		// level h of index i is stored at table[h * n + i], level 0 is the array
+		vector<Data> table;
+};
+
+template<class Data, class Operation> DisjointSparseTable<Data, Operation>::DisjointSparseTable(const vector<Data>& data,
+	const Operation& _op) : n(data.size()), levels(0), op(_op) {
+
+	if(n == 0) return;
+
+	levels = (n == 1 ? 0 : MyMath::log2(n - 1) + 1) + 1;
+	table.reserve((long long) levels * n);
+	table.insert(table.end(), data.begin(), data.end());
+
+	for(int h = 1;h < levels;h++) {
+		table.insert(table.end(), data.begin(), data.end());
+		Data *cur = &table[(long long) h * n];
+		for(int mid = 1 << (h-1);mid < n;mid += 1 << h) {
+			// suffix products of the left half, prefix products of the right half
+			for(int i = mid - 2;i >= mid - (1 << (h-1));i--) {
+				cur[i] = op(data[i], cur[i+1]);
+			}
+			for(int i = mid + 1;i < n and i < mid + (1 << (h-1));i++) {
+				cur[i] = op(cur[i-1], data[i]);
+			}
+		}
+	}
+}
+
+template<class Data, class Operation> DisjointSparseTable<Data, Operation>::DisjointSparseTable(void) : n(0), levels(0) {}
+
+template<class Data, class Operation> int DisjointSparseTable<Data, Operation>::size(void) const {
+	return n;
+}
+
+template<class Data, class Operation> Data DisjointSparseTable<Data, Operation>::query(int idx1, int idx2) const {
+	if(idx1 > idx2) swap(idx1, idx2);
+	if(idx1 < 0) idx1 = 0;
+	if(idx2 >= n) idx2 = n - 1;
+	if(idx1 == idx2) return table[idx1];
+	int h = MyMath::log2(idx1 ^ idx2) + 1;
+	return op(table[(long long) h * n + idx1], table[(long long) h * n + idx2]);
+}
+
+template<class Data, class Operation> const Data& DisjointSparseTable<Data, Operation>::operator[](int idx) const {
+	return table[idx];
+}
+
+#endif
@@ -1,32 +1,53 @@
+/*
+Fibonacci Heap
+
+push returns a handle (the node of the element), decreasekey takes
+the handle. push, top, meld and decreasekey take O(1) amortized
+time, pop takes O(log n) amortized.
+
+The roots and the children of every node are circular doubly linked
+lists, so meld splices two root lists in O(1). Nodes come from a
+NodePool, pop recycles them and meld takes the other heap's nodes
+without copying, leaving it empty. Joining the two pools is O(1) as
+well, so meld is O(1) in the worst case. pop links the roots through one
+degree table that is kept between calls, its size is bounded by
+log_phi(n) + 2.
+
+link_count, cut_count and cascading_cut_count count the work done
+so far, cascading cuts are the cuts of marked ancestors made by
+decreasekey and are also counted in cut_count.
+*/
 
 #ifndef __FIBONACCI_HEAP__
 
 #define __FIBONACCI_HEAP__
 
+#include "MyMath.cpp"
+#include "NodePool.cpp"
 #include <vector>
 
 using namespace std;
 
 template<class Data> class FibonacciHeap {
-	
+
 	public :
-		
+
 		class iterator {
 
 			public :
-	
+
 				bool mark;
-				int id, deg;
+				int deg;
 				Data key;
 				iterator *parent, *left, *right, *left_child;
-	
-				iterator(Data k) : key(k), deg(0), parent(NULL), mark(false),
-					left(NULL), left_child(NULL), right(NULL) {}
-				~iterator(void) {}
 		};
 
 		int total_size;
-		iterator *min_node, *root;
+		iterator *min_node;
+		long long link_count, cut_count, cascading_cut_count;
+
+		NodePool<iterator> nodes;
+		vector<iterator*> degree_table;
 
 		bool empty(void) {
 			return min_node == NULL;
@@ -36,164 +57,202 @@ template<class Data> class FibonacciHeap {
 			return total_size;
 		}
 
+		// put v into the circular list that contains head
+		void insert_list(iterator *head, iterator *v) {
+			v->left = head;
+			v->right = head->right;
+			head->right->left = v;
+			head->right = v;
+		}
+
+		void remove_list(iterator *v) {
+			v->left->right = v->right;
+			v->right->left = v->left;
+		}
+
 		void insert_root(iterator *new_node) {
 
-			if(root == NULL) {
-				root = new_node;
-				root->left = root->right = root;
-			}else {
-				new_node->right = root->right;
-				new_node->left = root;
-				root->right = new_node;
-			}
+			new_node->parent = NULL;
+			new_node->mark = false;
 
-			if(min_node == NULL or new_node->key < min_node->key) {
+			if(min_node == NULL) {
+				new_node->left = new_node->right = new_node;
 				min_node = new_node;
+			}else {
+				insert_list(min_node, new_node);
+				if(new_node->key < min_node->key) {
+					min_node = new_node;
+				}
 			}
 		}
 
 		iterator* push(Data new_data) {
-			iterator *new_node = new iterator(new_data);
+			iterator *new_node = nodes.allocate();
+			new_node->key = new_data;
+			new_node->deg = 0;
+			new_node->left_child = NULL;
 			insert_root(new_node);
 			total_size++;
 			return new_node;
 		}
 
+		// move current from its parent's children to the roots
 		void cut(iterator *current) {
-			if(current->parent == NULL) return;
 			iterator *ancestor = current->parent;
-			ancestor->mark = false;
-			if(current->left == NULL) {
-				ancestor->left_child = current->right;
+			if(current->right == current) {
+				ancestor->left_child = NULL;
 			}else {
-				current->left->right = current->right;
-			}
-			if(current->right != NULL) {
-				current->right->left = current->left;
-			}
-			current->left = current->right = current->parent = NULL;
-			if(ancestor->parent != NULL and ancestor->mark) {
-				cut(ancestor);
-			}else {
-				ancestor->mark = true;
+				remove_list(current);
+				if(ancestor->left_child == current) {
+					ancestor->left_child = current->right;
+				}
 			}
+			ancestor->deg--;
+			insert_root(current);
+			cut_count++;
 		}
 
 		void decreasekey(iterator *current, Data new_key) {
 
 			current->key = new_key;
 			iterator *ancestor = current->parent;
-			
+
 			if(ancestor == NULL or !(current->key < ancestor->key)) {
 				// heap constraints is not violate
+				if(ancestor == NULL and current->key < min_node->key) {
+					min_node = current;
+				}
 				return;
 			}
 
 			cut(current);
+
+			// a marked ancestor has already lost a child, cut it as well
+			for(current = ancestor;current->parent != NULL and current->mark;current = ancestor) {
+				ancestor = current->parent;
+				cut(current);
+				cascading_cut_count++;
+			}
+			if(current->parent != NULL) {
+				current->mark = true;
+			}
 		}
 
-		void Consolidate(void) {
+		// v becomes a child of u
+		void link(iterator *u, iterator *v) {
+			v->parent = u;
+			v->mark = false;
+			if(u->left_child == NULL) {
+				v->left = v->right = v;
+				u->left_child = v;
+			}else {
+				insert_list(u->left_child, v);
+			}
+			u->deg++;
+			link_count++;
+		}
 
-			if(empty()) return;
+		void Consolidate(iterator *start) {
 
-			vector<iterator*> new_root;
-			
-			bool first = true; 
-			
-			for(iterator *u = root; u != root or first;) {
+			// no degree can exceed log_phi(n) < 1.4405 log2(n)
+			int bound = (int) (1.4405 * (MyMath::log2(total_size) + 1)) + 2;
+			if(degree_table.size() < bound) {
+				degree_table.resize(bound, NULL);
+			}
 
+			// the root list is rebuilt from the table, so it is walked
+			// only through the links of roots not visited yet
+			iterator *u = start;
+			do {
 				iterator *nxt = u->right;
-
-				first = false;
-
-				if(u == min_node) {
-					u = nxt;
-					continue;
-				}
-
-				if(new_root.size() <= u->deg) {
-					new_root.resize(u->deg + 1, NULL);
-				}
-			
-				while(new_root[u->deg] != NULL) {
-			
-					iterator *v = new_root[u->deg];
-
+				while(degree_table[u->deg] != NULL) {
+					iterator *v = degree_table[u->deg];
+					degree_table[u->deg] = NULL;
 					if(v->key < u->key) {
-						swap(v, u);
-					}
-
-					v->parent = u;
-					v->left = NULL;
-					v->right = u->left_child;
-					if(v->right != NULL) v->right->left = v;
-					u->left_child = v;
-					new_root[u->deg] = NULL;
-			
-					u->deg++;
-			
-					if(new_root.size() <= u->deg) {
-						new_root.resize(u->deg + 1, NULL);
+						swap(u, v);
 					}
-				} 
-
-				new_root[u->deg] = u;
-			
+					link(u, v);
+				}
+				degree_table[u->deg] = u;
 				u = nxt;
-			}
+			} while(u != start);
 
-			root = NULL;
-			delete min_node;
 			min_node = NULL;
-
-			for(iterator *u : new_root) {
-				if(u != NULL) {
-					insert_root(u);
+			for(int i = 0;i < degree_table.size();i++) {
+				if(degree_table[i] != NULL) {
+					insert_root(degree_table[i]);
+					degree_table[i] = NULL;
 				}
 			}
-
 		}
 
 		void pop(void) {
-			
+
 			if(empty()) {
 				return;
 			}
-				
-			for(iterator *v = min_node->left_child;v != NULL;) {
-				iterator *nxt = v->right;
-				v->parent = v->left = v->right = NULL;
-				v->mark = false;
-				insert_root(v);
-				v = nxt;
+
+			iterator *z = min_node;
+
+			// the children join the roots, then z leaves them
+			if(z->left_child != NULL) {
+				iterator *c = z->left_child;
+				do {
+					c->parent = NULL;
+					c = c->right;
+				} while(c != z->left_child);
+				iterator *z_right = z->right, *c_left = c->left;
+				z->right = c;
+				c->left = z;
+				c_left->right = z_right;
+				z_right->left = c_left;
 			}
-			
-			min_node->deg = 0;
-			min_node->left_child = NULL;
 
-			Consolidate();
+			iterator *start = (z->right == z ? NULL : z->right);
+			remove_list(z);
+			nodes.release(z);
 			total_size--;
+
+			min_node = NULL;
+			if(start != NULL) {
+				Consolidate(start);
+			}
 		}
 
 		Data top(void) {
-			if(not empty()) {
-				return min_node->key;
+			if(empty()) {
+				return Data();
 			}
+			return min_node->key;
 		}
 
-		void meld(FibonacciHeap<Data> H2) {
-			if(empty()) return H2;
-			if(H2.empty()) return *this;
-			iterator *u1 = root, *u2 = root->right;
-			iterator *v1 = H2.root, v2 = H2.root->left;
-			u1->right = v1;
-			v1->left = u1;
-			u2->left = v2;
-			v2->right = u2;
+		// move every element of H2 into this heap, H2 becomes empty
+		void meld(FibonacciHeap<Data> &H2) {
+			if(&H2 == this or H2.empty()) return;
+			nodes.splice(H2.nodes);
+			if(empty()) {
+				min_node = H2.min_node;
+			}else {
+				iterator *u1 = min_node, *u2 = min_node->right;
+				iterator *v1 = H2.min_node, *v2 = H2.min_node->left;
+				u1->right = v1;
+				v1->left = u1;
+				v2->right = u2;
+				u2->left = v2;
+				if(H2.min_node->key < min_node->key) {
+					min_node = H2.min_node;
+				}
+			}
+			total_size += H2.total_size;
+			link_count += H2.link_count;
+			cut_count += H2.cut_count;
+			cascading_cut_count += H2.cascading_cut_count;
+			H2.min_node = NULL;
+			H2.total_size = 0;
+			H2.link_count = H2.cut_count = H2.cascading_cut_count = 0;
 		}
 
-		FibonacciHeap(void) : min_node(NULL), root(NULL), total_size(0) {}
-		~FibonacciHeap(void) {}
+		FibonacciHeap(void) : total_size(0), min_node(NULL), link_count(0), cut_count(0), cascading_cut_count(0) {}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,274 @@
+/*
+Flat Van Embe Boas Tree
+
+Same interface as VEB, but the tree is laid out as flat bitmaps
+instead of pointer nodes. The bottom level stores one bit per key
+in 64-bit words, and every level above stores one bit per
+non-empty word of the level below. A universe of 2^24 therefore
+has only 4 levels, and each step inside a word is a single
+ctz / clz, so successor and predecessor do O(log U / 6) word
+operations without chasing pointers.
+
+This tree requires U / 8 bytes plus about 2% for the summaries.
+
+This code is written in C++.
+Everyone is free to use this code.
+*/
+
+#ifndef __FLAT_VAN_EMBE_BOAS__
+
+#define __FLAT_VAN_EMBE_BOAS__
+
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+class FlatVEB {
+
+  private:
+
+    static const int error_code = -1;
+
+    // level[0] has one bit per key, level[k+1] one bit per
+    // non-empty word of level[k], the last level is a single word
+    vector< vector<unsigned long long> > level;
+    int bit_len;
+
+    void init(int);
+    void build_summary(void);
+
+  public :
+
+    // ordered iteration, end() is one past max() and --end() is max()
+    class iterator {
+
+      private :
+
+        FlatVEB *tree;
+        int key;
+
+      public :
+
+        iterator(FlatVEB *_tree, int _key) : tree(_tree), key(_key) {}
+        int operator*(void) const {
+          return key;
+        }
+        iterator& operator++(void) {
+          key = tree->successor(key);
+          return *this;
+        }
+        iterator& operator--(void) {
+          key = (key == tree->error() ? tree->max() : tree->predecessor(key));
+          return *this;
+        }
+        bool operator==(const iterator& it) const {
+          return key == it.key;
+        }
+        bool operator!=(const iterator& it) const {
+          return key != it.key;
+        }
+    };
+
+    // list of functions that are accessible
+    FlatVEB(int);
+    template<class Iterator> FlatVEB(int, Iterator, Iterator);
+    FlatVEB(int, const vector<unsigned long long>&);
+
+    int size(void);
+    bool empty(void);
+    int error(void);
+    int min(void);
+    int max(void);
+
+    bool find(int);
+    int successor(int);
+    int predecessor(int);
+    void insert(int);
+    void erase(int);
+
+    iterator begin(void);
+    iterator end(void);
+    iterator lower_bound(int);
+    template<class Function> void for_each_in_range(int, int, Function);
+
+};
+
+void FlatVEB::init(int _len) {
+  bit_len = _len;
+  long long words = 1LL << bit_len;
+  level.clear();
+  do {
+    words = (words + 63) >> 6;
+    level.push_back(vector<unsigned long long>(words, 0));
+  } while(words > 1);
+}
+
+// rebuild every summary level from the level below in O(U / 64)
+void FlatVEB::build_summary(void) {
+  for(int k = 0;k + 1 < level.size();k++) {
+    fill(level[k+1].begin(), level[k+1].end(), 0);
+    for(int w = 0;w < level[k].size();w++) {
+      if(level[k][w] != 0) {
+        level[k+1][w >> 6] |= 1ULL << (w & 63);
+      }
+    }
+  }
+}
+
+FlatVEB::FlatVEB(int _len) {
+  init(_len);
+}
+
+// bulk build from a range of keys, out of range keys are ignored
+template<class Iterator> FlatVEB::FlatVEB(int _len, Iterator first, Iterator last) {
+  init(_len);
+  for(;first != last;++first) {
+    int val = *first;
+    if(val < 0 or val >= size()) continue;
+    level[0][val >> 6] |= 1ULL << (val & 63);
+  }
+  build_summary();
+}
+
+// bulk build from a bitmap, bit i of word w is the key 64 * w + i
+FlatVEB::FlatVEB(int _len, const vector<unsigned long long>& bitmap) {
+  init(_len);
+  copy(bitmap.begin(), bitmap.begin() + std::min(bitmap.size(), level[0].size()), level[0].begin());
+  if(bit_len < 6) {
+    level[0][0] &= (1ULL << size()) - 1;
+  }
+  build_summary();
+}
+
+int FlatVEB::size(void) {
+  return 1 << bit_len;
+}
+bool FlatVEB::empty(void) {
+  return level.back()[0] == 0;
+}
+int FlatVEB::error(void) {
+  return error_code;
+}
+
+int FlatVEB::min(void) {
+  if(empty()) return error();
+  int x = 0;
+  for(int k = level.size()-1;k >= 0;k--) {
+    x = (x << 6) | __builtin_ctzll(level[k][x]);
+  }
+  return x;
+}
+int FlatVEB::max(void) {
+  if(empty()) return error();
+  int x = 0;
+  for(int k = level.size()-1;k >= 0;k--) {
+    x = (x << 6) | (63 - __builtin_clzll(level[k][x]));
+  }
+  return x;
+}
+
+bool FlatVEB::find(int val) {
+  if(val < 0 or val >= size()) return false;
+  return level[0][val >> 6] >> (val & 63) & 1;
+}
+
+// go up until a word has a bit at or after the position,
+// then go down taking the lowest bit of every word
+int FlatVEB::successor(int val) {
+  if(val < 0) return min();
+  if(val >= size() - 1) return error();
+  int x = val + 1, k = 0;
+  for(;k < level.size();k++) {
+    int w = x >> 6;
+    if(w >= level[k].size()) return error();
+    unsigned long long m = level[k][w] & (~0ULL << (x & 63));
+    if(m != 0) {
+      x = (w << 6) | __builtin_ctzll(m);
+      break;
+    }
+    x = w + 1;
+  }
+  if(k == level.size()) return error();
+  for(;k > 0;k--) {
+    x = (x << 6) | __builtin_ctzll(level[k-1][x]);
+  }
+  return x;
+}
+
+int FlatVEB::predecessor(int val) {
+  if(val >= size()) return max();
+  if(val <= 0) return error();
+  int x = val - 1, k = 0;
+  for(;k < level.size();k++) {
+    int w = x >> 6;
+    unsigned long long m = level[k][w] & (~0ULL >> (63 - (x & 63)));
+    if(m != 0) {
+      x = (w << 6) | (63 - __builtin_clzll(m));
+      break;
+    }
+    if(w == 0) return error();
+    x = w - 1;
+  }
+  if(k == level.size()) return error();
+  for(;k > 0;k--) {
+    x = (x << 6) | (63 - __builtin_clzll(level[k-1][x]));
+  }
+  return x;
+}
+
+// a summary bit only changes when a word becomes empty or non-empty
+void FlatVEB::insert(int val) {
+  if(val < 0 or val >= size()) return;
+  for(int k = 0;k < level.size();k++) {
+    unsigned long long &word = level[k][val >> 6];
+    bool was_empty = (word == 0);
+    word |= 1ULL << (val & 63);
+    if(!was_empty) return;
+    val >>= 6;
+  }
+}
+
+void FlatVEB::erase(int val) {
+  if(val < 0 or val >= size()) return;
+  for(int k = 0;k < level.size();k++) {
+    unsigned long long &word = level[k][val >> 6];
+    word &= ~(1ULL << (val & 63));
+    if(word != 0) return;
+    val >>= 6;
+  }
+}
+
+FlatVEB::iterator FlatVEB::begin(void) {
+  return iterator(this, min());
+}
+FlatVEB::iterator FlatVEB::end(void) {
+  return iterator(this, error());
+}
+// first key not less than val
+FlatVEB::iterator FlatVEB::lower_bound(int val) {
+  return iterator(this, find(val) ? val : successor(val));
+}
+
+// call f on every key in [lo, hi] in increasing order, the bits of
+// a word are streamed directly and only empty words are skipped
+// through the summaries
+template<class Function> void FlatVEB::for_each_in_range(int lo, int hi, Function f) {
+  lo = std::max(lo, 0);
+  hi = std::min(hi, size() - 1);
+  if(lo > hi) return;
+  int x = find(lo) ? lo : successor(lo);
+  while(x != error() and x <= hi) {
+    int base = x & ~63;
+    unsigned long long m = level[0][x >> 6] & (~0ULL << (x & 63));
+    while(m != 0) {
+      int y = base + __builtin_ctzll(m);
+      if(y > hi) return;
+      f(y);
+      m &= m - 1;
+    }
+    x = successor(base + 63);
+  }
+}
+
+#endif
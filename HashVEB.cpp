@@ -0,0 +1,376 @@
+/*
+Hashed Van Embe Boas Tree
+
+Same operations as VEB for 64-bit keys. Clusters of every node
+are kept in an open-addressing hash table and created only when
+they become non-empty, and a node is freed as soon as it becomes
+empty, so the tree needs O(n) memory for n keys whatever the
+universe is. Universes of up to 2^6 are a single 64-bit word.
+
+successor, predecessor, insert and erase take O(log log U)
+expected time, that is about 5 levels for U = 2^64.
+
+error() is 2^64 - 1, so that key cannot be stored when bit_len
+is 64.
+
+This code is written in C++.
+Everyone is free to use this code.
+*/
+
+#ifndef __HASH_VAN_EMBE_BOAS__
+
+#define __HASH_VAN_EMBE_BOAS__
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+class HashVEB {
+
+  public :
+
+    typedef unsigned long long Key;
+
+  private:
+
+    static const Key none = ~0ULL;
+
+    class VEB_NODE;
+
+    // open addressing with linear probing and backward shift deletion
+    class ClusterTable {
+
+      private :
+
+        vector<Key> keys;
+        vector<VEB_NODE*> vals;
+        int cnt;
+
+        static Key hash(Key);
+
+      public :
+
+        ClusterTable(void);
+        ~ClusterTable(void);
+        VEB_NODE* get(Key) const;
+        void put(Key, VEB_NODE*);
+        void erase(Key);
+        void clear(void);
+    };
+
+    class VEB_NODE {
+
+      private :
+
+        int len, half_len;
+        Key min, max;
+        unsigned long long bits;
+        VEB_NODE* summary;
+        ClusterTable cluster;
+
+        Key high(Key);
+        Key low(Key);
+        Key index(Key, Key);
+
+      public :
+
+        VEB_NODE(int);
+        ~VEB_NODE(void);
+        bool empty(void);
+        Key find_min(void);
+        Key find_max(void);
+        bool find(Key);
+        Key successor(Key);
+        Key predecessor(Key);
+        void insert(Key);
+        void erase(Key);
+    };
+
+    VEB_NODE *head;
+    int bit_len;
+
+  public :
+
+    // list of functions that are accessible
+    HashVEB(int);
+    ~HashVEB(void);
+
+    int bits(void);
+    bool empty(void);
+    Key error(void);
+    Key min(void);
+    Key max(void);
+
+    bool find(Key);
+    Key successor(Key);
+    Key predecessor(Key);
+    void insert(Key);
+    void erase(Key);
+
+};
+
+// cluster table
+
+HashVEB::ClusterTable::ClusterTable(void) : cnt(0) {}
+
+// the table owns the clusters left in it
+HashVEB::ClusterTable::~ClusterTable(void) {
+  for(int i = 0;i < vals.size();i++) {
+    delete vals[i];
+  }
+}
+
+HashVEB::Key HashVEB::ClusterTable::hash(Key x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return x;
+}
+
+HashVEB::VEB_NODE* HashVEB::ClusterTable::get(Key k) const {
+  if(cnt == 0) return NULL;
+  Key mask = keys.size() - 1;
+  for(Key i = hash(k) & mask;vals[i] != NULL;i = (i + 1) & mask) {
+    if(keys[i] == k) return vals[i];
+  }
+  return NULL;
+}
+
+void HashVEB::ClusterTable::put(Key k, VEB_NODE* v) {
+  if(2 * (cnt + 1) > (int) keys.size()) {
+    vector<Key> old_keys(keys.size() < 4 ? 4 : 2 * keys.size());
+    vector<VEB_NODE*> old_vals(old_keys.size(), NULL);
+    old_keys.swap(keys);
+    old_vals.swap(vals);
+    cnt = 0;
+    for(int i = 0;i < old_keys.size();i++) {
+      if(old_vals[i] != NULL) put(old_keys[i], old_vals[i]);
+    }
+  }
+  Key mask = keys.size() - 1, i = hash(k) & mask;
+  while(vals[i] != NULL and keys[i] != k) {
+    i = (i + 1) & mask;
+  }
+  if(vals[i] == NULL) cnt++;
+  keys[i] = k;
+  vals[i] = v;
+}
+
+void HashVEB::ClusterTable::erase(Key k) {
+  if(cnt == 0) return;
+  Key mask = keys.size() - 1, i = hash(k) & mask;
+  while(vals[i] != NULL and keys[i] != k) {
+    i = (i + 1) & mask;
+  }
+  if(vals[i] == NULL) return;
+  // move back every entry that would not be found past the hole
+  for(Key j = (i + 1) & mask;vals[j] != NULL;j = (j + 1) & mask) {
+    Key home = hash(keys[j]) & mask;
+    if(((j - home) & mask) >= ((j - i) & mask)) {
+      keys[i] = keys[j];
+      vals[i] = vals[j];
+      i = j;
+    }
+  }
+  vals[i] = NULL;
+  cnt--;
+  if(cnt == 0) clear();
+}
+
+void HashVEB::ClusterTable::clear(void) {
+  vector<Key>().swap(keys);
+  vector<VEB_NODE*>().swap(vals);
+  cnt = 0;
+}
+
+// tree nodes
+
+HashVEB::VEB_NODE::VEB_NODE(int _len) {
+  len = _len;
+  half_len = (len >> 1);
+  min = max = none;
+  bits = 0;
+  summary = NULL;
+}
+HashVEB::VEB_NODE::~VEB_NODE(void) {
+  delete summary;
+}
+
+HashVEB::Key HashVEB::VEB_NODE::high(Key val) {
+  return val >> half_len;
+}
+HashVEB::Key HashVEB::VEB_NODE::low(Key val) {
+  return val & ((1ULL << half_len) - 1);
+}
+HashVEB::Key HashVEB::VEB_NODE::index(Key h, Key l) {
+  return (h << half_len) | l;
+}
+
+bool HashVEB::VEB_NODE::empty(void) {
+  if(len <= 6) return bits == 0;
+  return min == none;
+}
+HashVEB::Key HashVEB::VEB_NODE::find_min(void) {
+  if(len <= 6) return bits == 0 ? none : __builtin_ctzll(bits);
+  return min;
+}
+HashVEB::Key HashVEB::VEB_NODE::find_max(void) {
+  if(len <= 6) return bits == 0 ? none : 63 - __builtin_clzll(bits);
+  return max;
+}
+
+bool HashVEB::VEB_NODE::find(Key val) {
+  if(len <= 6) return bits >> val & 1;
+  if(min == none) return false;
+  if(val == min or val == max) return true;
+  VEB_NODE *c = cluster.get(high(val));
+  return c != NULL and c->find(low(val));
+}
+
+// smallest key greater than val
+HashVEB::Key HashVEB::VEB_NODE::successor(Key val) {
+  if(len <= 6) {
+    unsigned long long m = (val >= 63) ? 0 : bits & (~0ULL << (val + 1));
+    return m == 0 ? none : __builtin_ctzll(m);
+  }
+  if(min == none or val >= max) return none;
+  if(val < min) return min;
+  Key h = high(val), l = low(val);
+  VEB_NODE *c = cluster.get(h);
+  if(c != NULL and l < c->find_max()) {
+    return index(h, c->successor(l));
+  }
+  Key nh = summary->successor(h);
+  return index(nh, cluster.get(nh)->find_min());
+}
+
+// largest key smaller than val
+HashVEB::Key HashVEB::VEB_NODE::predecessor(Key val) {
+  if(len <= 6) {
+    unsigned long long m = (val > 63) ? bits : bits & ((1ULL << val) - 1);
+    return m == 0 ? none : 63 - __builtin_clzll(m);
+  }
+  if(min == none or val <= min) return none;
+  if(val > max) return max;
+  Key h = high(val), l = low(val);
+  VEB_NODE *c = cluster.get(h);
+  if(c != NULL and l > c->find_min()) {
+    return index(h, c->predecessor(l));
+  }
+  Key ph = (summary == NULL ? none : summary->predecessor(h));
+  if(ph == none) return min;
+  return index(ph, cluster.get(ph)->find_max());
+}
+
+// the minimum is kept only in the node, every other key also lives in a cluster
+void HashVEB::VEB_NODE::insert(Key val) {
+  if(len <= 6) {
+    bits |= 1ULL << val;
+    return;
+  }
+  if(min == none) {
+    min = max = val;
+    return;
+  }
+  if(val == min) return;
+  if(val < min) swap(min, val);
+  if(val > max) max = val;
+
+  Key h = high(val);
+  VEB_NODE *c = cluster.get(h);
+  if(c == NULL) {
+    c = new VEB_NODE(half_len);
+    cluster.put(h, c);
+    if(summary == NULL) summary = new VEB_NODE(len - half_len);
+    summary->insert(h);
+  }
+  c->insert(low(val));
+}
+
+void HashVEB::VEB_NODE::erase(Key val) {
+  if(len <= 6) {
+    bits &= ~(1ULL << val);
+    return;
+  }
+  if(min == none) return;
+  if(min == max) {
+    if(val == min) min = max = none;
+    return;
+  }
+  if(val == min) {
+    // pull the next key out of its cluster to become the minimum
+    Key h = summary->find_min();
+    val = min = index(h, cluster.get(h)->find_min());
+  }
+
+  Key h = high(val);
+  VEB_NODE *c = cluster.get(h);
+  if(c == NULL) return;
+  c->erase(low(val));
+  if(c->empty()) {
+    delete c;
+    cluster.erase(h);
+    summary->erase(h);
+    if(summary->empty()) {
+      delete summary;
+      summary = NULL;
+    }
+  }
+
+  if(val == max) {
+    if(summary == NULL) {
+      max = min;
+    }else {
+      Key mh = summary->find_max();
+      max = index(mh, cluster.get(mh)->find_max());
+    }
+  }
+}
+
+// these functions are publicly accessable
+HashVEB::HashVEB(int _len) {
+  bit_len = _len;
+  head = new VEB_NODE(bit_len);
+}
+HashVEB::~HashVEB(void) {
+  delete head;
+}
+int HashVEB::bits(void) {
+  return bit_len;
+}
+bool HashVEB::empty(void) {
+  return head->empty();
+}
+HashVEB::Key HashVEB::error(void) {
+  return none;
+}
+HashVEB::Key HashVEB::min(void) {
+  return head->find_min();
+}
+HashVEB::Key HashVEB::max(void) {
+  return head->find_max();
+}
+bool HashVEB::find(Key val) {
+  if(bit_len < 64 and val >> bit_len) return false;
+  return head->find(val);
+}
+HashVEB::Key HashVEB::successor(Key val) {
+  if(bit_len < 64 and val >> bit_len) return error();
+  return head->successor(val);
+}
+HashVEB::Key HashVEB::predecessor(Key val) {
+  if(bit_len < 64 and val >> bit_len) return max();
+  return head->predecessor(val);
+}
+void HashVEB::insert(Key val) {
+  if(bit_len < 64 and val >> bit_len) return;
+  if(val == none) return;
+  head->insert(val);
+}
+void HashVEB::erase(Key val) {
+  if(bit_len < 64 and val >> bit_len) return;
+  head->erase(val);
+}
+
+#endif
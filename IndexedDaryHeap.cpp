@@ -0,0 +1,160 @@
+/*
+Indexed D-ary Heap
+
+An implicit D-ary min heap over the ids [0, n), for dense keyspaces
+such as the vertices of a graph. The handle of an element is its
+id, so push(id, key), decreasekey(id, key), top and pop play the
+same roles as in FibonacciHeap without any node allocation. All
+memory is allocated by the constructor.
+
+The heap array holds (key, id) pairs so a sift never leaves the
+array, and pos[id] is the place of id in it (-1 when absent). The
+array is shifted so that the D children of a node start at a
+multiple of D on a 64-byte boundary, with D = 8 and 8-byte pairs
+(or D = 4 and 16-byte pairs) the children are one cache line.
+
+push and decreasekey take O(log_D n), pop takes O(D log_D n).
+*/
+
+#ifndef __INDEXED_DARY_HEAP__
+
+#define __INDEXED_DARY_HEAP__
+
+#include <vector>
+
+using namespace std;
+
+template<class Key, int D = 4> class IndexedDaryHeap {
+
+	private :
+
+		struct Entry {
+			Key key;
+			int id;
+		};
+
+		// logical index i is stored at heap[base + i]
+		vector<Entry> heap;
+		vector<int> pos;
+		int base, total_size;
+
+		Entry& at(int i) {
+			return heap[base + i];
+		}
+
+		void place(int i, const Entry &e) {
+			at(i) = e;
+			pos[e.id] = i;
+		}
+
+		void sift_up(int i) {
+			Entry e = at(i);
+			while(i > 0) {
+				int p = (i - 1) / D;
+				if(!(e.key < at(p).key)) break;
+				place(i, at(p));
+				i = p;
+			}
+			place(i, e);
+		}
+
+		void sift_down(int i) {
+			Entry e = at(i);
+			for(;;) {
+				int first = D * i + 1;
+				if(first >= total_size) break;
+				int last = first + D < total_size ? first + D : total_size;
+				int c = first;
+				for(int j = first + 1;j < last;j++) {
+					if(at(j).key < at(c).key) c = j;
+				}
+				if(!(at(c).key < e.key)) break;
+				place(i, at(c));
+				i = c;
+			}
+			place(i, e);
+		}
+
+	public :
+
+		IndexedDaryHeap(int n) : pos(n, -1), total_size(0) {
+			// the child groups start at base + D * (i + 1) - 1, pad so
+			// that this is a multiple of D from a 64-byte boundary
+			heap.resize(n + D + 64 / sizeof(Entry) + 1);
+			size_t addr = (size_t) &heap[0];
+			int shift = (64 - addr % 64) % 64 / sizeof(Entry);
+			base = shift + D - 1;
+		}
+
+		bool empty(void) {
+			return total_size == 0;
+		}
+
+		int size(void) {
+			return total_size;
+		}
+
+		// the number of ids, every id must be in [0, capacity())
+		int capacity(void) {
+			return pos.size();
+		}
+
+		bool contains(int id) {
+			return pos[id] != -1;
+		}
+
+		Key key(int id) {
+			return at(pos[id]).key;
+		}
+
+		// an id already in the heap gets the new key
+		void push(int id, Key new_key) {
+			if(contains(id)) {
+				Key old_key = key(id);
+				at(pos[id]).key = new_key;
+				if(new_key < old_key) {
+					sift_up(pos[id]);
+				}else {
+					sift_down(pos[id]);
+				}
+				return;
+			}
+			Entry e;
+			e.key = new_key;
+			e.id = id;
+			place(total_size++, e);
+			sift_up(total_size - 1);
+		}
+
+		void decreasekey(int id, Key new_key) {
+			at(pos[id]).key = new_key;
+			sift_up(pos[id]);
+		}
+
+		Key top(void) {
+			if(empty()) {
+				return Key();
+			}
+			return at(0).key;
+		}
+
+		int top_id(void) {
+			if(empty()) {
+				return -1;
+			}
+			return at(0).id;
+		}
+
+		void pop(void) {
+			if(empty()) {
+				return;
+			}
+			pos[at(0).id] = -1;
+			if(--total_size > 0) {
+				place(0, at(total_size));
+				sift_down(0);
+			}
+		}
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+LCA (Lowest Common Ancestor)
+
+Problem :
+input a rooted tree with vertices 0, 1, ..., n-1 in CSR form,
+the neighbours of vertex u are adj[start[u]], ..., adj[start[u+1]-1]
+(edges back to the parent are allowed and ignored)
+each query return the lowest common ancestor of u and v
+
+The tree is flattened into an Euler tour with an explicit stack,
+so deep trees do not overflow the call stack, and the depths along
+the tour are indexed by RMQ. After O(n) precomputation, lca and
+distance are answered in O(1).
+
+This code is for C++11 or newer version
+*/
+
+#ifndef __MYLIB__LCA__
+
+#define __MYLIB__LCA__
+
+#include "RMQ.cpp"
+#include <vector>
+
+using namespace std;
+
+class LCA {
+
+	public:
+
+		LCA(const vector<int>&, const vector<int>&, int = 0, int = __RMQ_TYPE_N__);
+
+		int size(void) const;
+		int depth(int) const;
+		int lca(int, int) const;
+		int distance(int, int) const;
+
+		// batched queries
+		vector<int> lca(const vector< pair<int, int> >&) const;
+		vector<int> distance(const vector< pair<int, int> >&) const;
+
+	private:
+
+		vector<int> EulerTour, FirstPosition, Depth;
+		RMQ<int> rmq;
+};
+
+LCA::LCA(const vector<int>& start, const vector<int>& adj, int root, int algorithm) {
+
+	int n = (int) start.size() - 1;
+	if(n <= 0 or root < 0 or root >= n) return;
+
+	vector<int> cursor(start.begin(), start.end() - 1), height, stk;
+
+	Depth.assign(n, 0);
+	FirstPosition.assign(n, -1);
+
+	FirstPosition[root] = 0;
+	EulerTour.push_back(root);
+	height.push_back(0);
+	stk.push_back(root);
+
+	while(!stk.empty()) {
+		int u = stk.back();
+		if(cursor[u] < start[u+1]) {
+			int v = adj[cursor[u]++];
+			if(FirstPosition[v] != -1) continue;
+			Depth[v] = Depth[u] + 1;
+			FirstPosition[v] = EulerTour.size();
+			EulerTour.push_back(v);
+			height.push_back(Depth[v]);
+			stk.push_back(v);
+		}else {
+			stk.pop_back();
+			if(!stk.empty()) {
+				EulerTour.push_back(stk.back());
+				height.push_back(Depth[stk.back()]);
+			}
+		}
+	}
+
+	rmq = RMQ<int>(height, algorithm);
+}
+
+int LCA::size(void) const {
+	return Depth.size();
+}
+
+int LCA::depth(int u) const {
+	if(u < 0 or u >= size() or FirstPosition[u] == -1) return -1;
+	return Depth[u];
+}
+
+// return -1 when u or v is not reachable from the root
+int LCA::lca(int u, int v) const {
+	if(depth(u) == -1 or depth(v) == -1) return -1;
+	return EulerTour[rmq.query(FirstPosition[u], FirstPosition[v])];
+}
+
+// number of edges on the path between u and v
+int LCA::distance(int u, int v) const {
+	int w = lca(u, v);
+	if(w == -1) return -1;
+	return Depth[u] + Depth[v] - 2 * Depth[w];
+}
+
+vector<int> LCA::lca(const vector< pair<int, int> >& queries) const {
+	vector<int> ans(queries.size());
+	for(int i = 0;i < queries.size();i++) {
+		ans[i] = lca(queries[i].first, queries[i].second);
+	}
+	return ans;
+}
+
+vector<int> LCA::distance(const vector< pair<int, int> >& queries) const {
+	vector<int> ans(queries.size());
+	for(int i = 0;i < queries.size();i++) {
+		ans[i] = distance(queries[i].first, queries[i].second);
+	}
+	return ans;
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*
+Mapped RMQ
+
+A read-only view of a prebuilt RMQ sparse table stored in a file.
+save() writes the data and the table of an __RMQ_TYPE_NLOGN__ RMQ
+into a versioned binary file, open() maps it with mmap and answers
+queries directly on the mapped pages. Nothing is copied, so opening
+takes O(1) and processes mapping the same file share the page cache.
+
+File layout :
+header (magic, version, sizeof(Data), n, levels, offsets)
+Data[n]                     at data_offset
+int[levels][n]              at table_offset
+
+Data must be trivially copyable, and the file is only valid on
+machines with the same endianness and type sizes.
+
+This code is for C++11 or newer version, on POSIX systems
+*/
+
+#ifndef __MYLIB__MAPPED_RMQ__
+
+#define __MYLIB__MAPPED_RMQ__
+
+#include "RMQ.cpp"
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+template<class Data, class Compare = less<Data> > class MappedRMQ {
+
+	static_assert(is_trivially_copyable<Data>::value, "MappedRMQ needs trivially copyable data");
+
+	public:
+
+		static const unsigned int version = 1;
+
+		static bool save(const RMQ<Data, Compare>&, const char*);
+
+		MappedRMQ(const Compare& = Compare());
+		~MappedRMQ(void);
+
+		bool open(const char*);
+		void close(void);
+
+		bool empty(void) const;
+		long long size(void) const;
+		int query(int, int) const;
+		const Data& operator[](int) const;
+
+	private:
+
+		struct Header {
+			char magic[8];
+			unsigned int version, data_size;
+			long long n, levels, data_offset, table_offset;
+		};
+
+		MappedRMQ(const MappedRMQ&);
+		MappedRMQ& operator=(const MappedRMQ&);
+
+		mutable Compare cmp;
+		void *base;
+		size_t length;
+		long long n, levels;
+		const Data *data;
+		const int *table;
+};
+
+template<class Data, class Compare> MappedRMQ<Data, Compare>::MappedRMQ(const Compare& _cmp) :
+	cmp(_cmp), base(NULL), length(0), n(0), levels(0), data(NULL), table(NULL) {}
+
+template<class Data, class Compare> MappedRMQ<Data, Compare>::~MappedRMQ(void) {
+	close();
+}
+
+// write the index of an RMQ built with __RMQ_TYPE_NLOGN__
+template<class Data, class Compare> bool MappedRMQ<Data, Compare>::save(const RMQ<Data, Compare>& rmq, const char* path) {
+
+	if(rmq.type != __RMQ_TYPE_NLOGN__) return false;
+
+	Header H;
+	memset(&H, 0, sizeof(H));
+	memcpy(H.magic, "MYLIBRMQ", 8);
+	H.version = version;
+	H.data_size = sizeof(Data);
+	H.n = rmq.data.size();
+	H.levels = rmq.sparse_table.size();
+	H.data_offset = sizeof(Header);
+	H.table_offset = (H.data_offset + H.n * sizeof(Data) + 7) / 8 * 8;
+
+	FILE *f = fopen(path, "wb");
+	if(f == NULL) return false;
+
+	bool ok = fwrite(&H, sizeof(H), 1, f) == 1;
+	if(ok and H.n > 0) {
+		ok = fwrite(rmq.data.data(), sizeof(Data), H.n, f) == H.n;
+	}
+	static const char padding[8] = {0};
+	long long pad = H.table_offset - H.data_offset - H.n * (long long) sizeof(Data);
+	if(ok and pad > 0) {
+		ok = fwrite(padding, 1, pad, f) == pad;
+	}
+	for(int i = 0;ok and i < H.levels;i++) {
+		ok = fwrite(rmq.sparse_table[i].data(), sizeof(int), H.n, f) == H.n;
+	}
+
+	return fclose(f) == 0 and ok;
+}
+
+// map an index written by save(), return false if the file is not valid
+template<class Data, class Compare> bool MappedRMQ<Data, Compare>::open(const char* path) {
+
+	close();
+
+	int fd = ::open(path, O_RDONLY);
+	if(fd == -1) return false;
+
+	struct stat st;
+	if(fstat(fd, &st) == -1 or st.st_size < (off_t) sizeof(Header)) {
+		::close(fd);
+		return false;
+	}
+
+	void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(p == MAP_FAILED) return false;
+
+	// the sizes are checked by division against the file size first, so
+	// a corrupt header cannot overflow them, and the table must have
+	// every level a query of length n reads
+	const Header *H = (const Header*) p;
+	long long file_size = st.st_size;
+	bool ok = memcmp(H->magic, "MYLIBRMQ", 8) == 0 and H->version == version
+		and H->data_size == sizeof(Data) and H->n >= 0 and H->n <= INT_MAX and H->levels >= 0
+		and H->data_offset >= (long long) sizeof(Header) and H->data_offset <= H->table_offset
+		and H->table_offset <= file_size
+		and H->data_offset % alignof(Data) == 0 and H->table_offset % alignof(int) == 0
+		and H->n <= (H->table_offset - H->data_offset) / (long long) sizeof(Data)
+		and (H->n == 0 or H->levels == MyMath::log2(H->n) + 1)
+		and (H->n == 0 or H->levels <= (file_size - H->table_offset) / (long long) sizeof(int) / H->n);
+	if(!ok) {
+		munmap(p, st.st_size);
+		return false;
+	}
+
+	base = p;
+	length = st.st_size;
+	n = H->n;
+	levels = H->levels;
+	data = (const Data*) ((const char*) p + H->data_offset);
+	table = (const int*) ((const char*) p + H->table_offset);
+	return true;
+}
+
+template<class Data, class Compare> void MappedRMQ<Data, Compare>::close(void) {
+	if(base != NULL) {
+		munmap(base, length);
+	}
+	base = NULL;
+	length = 0;
+	n = levels = 0;
+	data = NULL;
+	table = NULL;
+}
+
+template<class Data, class Compare> bool MappedRMQ<Data, Compare>::empty(void) const {
+	return n == 0;
+}
+
+template<class Data, class Compare> long long MappedRMQ<Data, Compare>::size(void) const {
+	return n;
+}
+
+template<class Data, class Compare> int MappedRMQ<Data, Compare>::query(int idx1, int idx2) const {
+	if(empty()) return -1;
+	if(idx1 > idx2) swap(idx1, idx2);
+	if(idx1 < 0) idx1 = 0;
+	if(idx2 >= n) idx2 = (int) n - 1;
+	int x = MyMath::log2(idx2 - idx1 + 1);
+	int id1 = table[x * n + idx1];
+	int id2 = table[x * n + idx2 - (1 << x) + 1];
+	return !cmp(data[id2], data[id1]) ? id1 : id2;
+}
+
+template<class Data, class Compare> const Data& MappedRMQ<Data, Compare>::operator[](int idx) const {
+	return data[idx];
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+MultiQueue
+
+A relaxed priority queue of (key, value) pairs for many threads,
+after Rihani, Sanders and Dementiev. It is c * threads sequential
+binary heaps, each behind its own try-lock. push puts the pair into
+a random heap that is not locked. pop looks at the cached minimum
+of two random heaps and takes the smaller one, trying other pairs
+when the lock is taken. No thread ever waits for a lock.
+
+pop does not always return the smallest key. The rank error of a
+pop, the number of keys in the queue smaller than the key it
+returns, is O(c * threads) on average, which is enough for label
+correcting searches such as parallel Dijkstra or A*: a vertex that
+is popped too early is pushed again when its distance improves.
+rank(key) counts the keys smaller than key to measure it, it locks
+the heaps one at a time so the count is exact only when no other
+thread works on the queue.
+
+Every thread passes its own id in [0, threads) to push and pop, the
+id selects its random generator. Key must be a number (it is cached
+in an atomic). pop returns false when it saw every heap empty, with
+other threads still pushing that is not a proof that the queue is
+empty.
+
+This code is for C++11 or newer version, compile with -pthread.
+Everyone is free to use this code.
+*/
+
+#ifndef __MULTI_QUEUE__
+
+#define __MULTI_QUEUE__
+
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+template<class Key, class Value> class MultiQueue {
+
+	private :
+
+		// the fields used by other threads come first, the padding keeps
+		// them away from the next heap's cache line
+		struct Queue {
+			atomic<bool> locked;
+			atomic<int> count;
+			atomic<Key> top_key;
+			vector< pair<Key, Value> > heap;
+			char pad[64];
+		};
+
+		struct Random {
+			unsigned long long state;
+			char pad[64 - sizeof(unsigned long long)];
+		};
+
+		vector<Queue> queues;
+		vector<Random> random;
+
+		static bool later(const pair<Key, Value> &a, const pair<Key, Value> &b) {
+			return b.first < a.first;
+		}
+
+		// xorshift64*
+		int pick(int thread) {
+			unsigned long long &x = random[thread].state;
+			x ^= x >> 12;
+			x ^= x << 25;
+			x ^= x >> 27;
+			return (x * 2685821657736338717ULL >> 32) % queues.size();
+		}
+
+		bool try_lock(Queue &q) {
+			return !q.locked.load(memory_order_relaxed) and !q.locked.exchange(true, memory_order_acquire);
+		}
+
+		void unlock(Queue &q) {
+			q.count.store(q.heap.size(), memory_order_relaxed);
+			if(!q.heap.empty()) {
+				q.top_key.store(q.heap.front().first, memory_order_relaxed);
+			}
+			q.locked.store(false, memory_order_release);
+		}
+
+		// the heap whose cached minimum is smaller, an empty heap loses
+		int better(int i, int j) {
+			if(queues[i].count.load(memory_order_relaxed) == 0) return j;
+			if(queues[j].count.load(memory_order_relaxed) == 0) return i;
+			Key ki = queues[i].top_key.load(memory_order_relaxed);
+			Key kj = queues[j].top_key.load(memory_order_relaxed);
+			return kj < ki ? j : i;
+		}
+
+	public :
+
+		MultiQueue(int threads, int c = 2) : queues(c * threads), random(threads) {
+			for(int i = 0;i < queues.size();i++) {
+				queues[i].locked.store(false);
+				queues[i].count.store(0);
+				queues[i].top_key.store(Key());
+			}
+			for(int i = 0;i < threads;i++) {
+				random[i].state = 0x9E3779B97F4A7C15ULL * (i + 1);
+			}
+		}
+
+		int threads(void) {
+			return random.size();
+		}
+
+		int queue_count(void) {
+			return queues.size();
+		}
+
+		// exact only when no other thread is working
+		long long size(void) {
+			long long total = 0;
+			for(int i = 0;i < queues.size();i++) {
+				total += queues[i].count.load(memory_order_relaxed);
+			}
+			return total;
+		}
+
+		bool empty(void) {
+			return size() == 0;
+		}
+
+		void push(int thread, Key key, const Value &value) {
+			int i = pick(thread);
+			while(!try_lock(queues[i])) {
+				i = pick(thread);
+			}
+			Queue &q = queues[i];
+			q.heap.push_back(make_pair(key, value));
+			push_heap(q.heap.begin(), q.heap.end(), later);
+			unlock(q);
+		}
+
+		bool pop(int thread, Key &key, Value &value) {
+			for(int tries = 0;;tries++) {
+				int i = better(pick(thread), pick(thread));
+				if(queues[i].count.load(memory_order_relaxed) == 0) {
+					// both heaps look empty, scan all of them now and then
+					if(tries >= queues.size()) {
+						if(empty()) return false;
+						tries = 0;
+					}
+					continue;
+				}
+				Queue &q = queues[i];
+				if(!try_lock(q)) continue;
+				if(q.heap.empty()) {
+					unlock(q);
+					continue;
+				}
+				pop_heap(q.heap.begin(), q.heap.end(), later);
+				key = q.heap.back().first;
+				value = q.heap.back().second;
+				q.heap.pop_back();
+				unlock(q);
+				return true;
+			}
+		}
+
+		// the number of keys smaller than key, to measure the rank error
+		long long rank(Key key) {
+			long long ans = 0;
+			for(int i = 0;i < queues.size();i++) {
+				Queue &q = queues[i];
+				while(!try_lock(q));
+				for(int j = 0;j < q.heap.size();j++) {
+					if(q.heap[j].first < key) ans++;
+				}
+				unlock(q);
+			}
+			return ans;
+		}
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+Node Pool
+
+Allocator for the nodes of the pointer based heaps. Nodes are
+carved out of chunks, the first chunk holds one node and each new
+chunk is as large as the pool, so a heap of n elements makes
+O(log n) calls to new, none after it has reached its largest size,
+and owns less than 2n + 1 nodes. Released nodes go to a free list
+and are reused by the next allocation.
+
+A node is default constructed when it is first carved out of its
+chunk and destroyed with its chunk. release does not run the
+destructor, the heap overwrites the fields it uses on the next
+allocation. A free node of a trivially copyable type holds the free
+list link in its own bytes, other types carry one extra pointer.
+
+The chunks, the chunks with nodes not carved yet and the free nodes
+are three linked lists with head and tail, so splice takes every
+node of another pool in O(1), this is what lets two heaps meld
+without copying their nodes. splice adds no chunk, the memory of
+the two pools is only put together.
+
+This code is written in C++.
+Everyone is free to use this code.
+*/
+
+#ifndef __MYLIB__NODE_POOL__
+
+#define __MYLIB__NODE_POOL__
+
+#include <new>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// value must stay the first field, release finds the slot from it. A
+// released node of a trivially copyable type keeps the free list link
+// in its own bytes, other types get an extra pointer for it.
+template<class T, bool inside> struct NodePoolSlot {
+	T value;
+	void *next;
+	void* link(void) {
+		return &next;
+	}
+};
+
+template<class T> struct NodePoolSlot<T, true> {
+	T value;
+	void* link(void) {
+		return &value;
+	}
+};
+
+template<class T> class NodePool {
+
+	private :
+
+		static const bool link_inside = is_trivially_copyable<T>::value and sizeof(T) >= sizeof(void*);
+		typedef NodePoolSlot<T, link_inside> Slot;
+
+		static Slot* get_next(Slot *s) {
+			Slot *nxt;
+			memcpy(&nxt, s->link(), sizeof(Slot*));
+			return nxt;
+		}
+		static void set_next(Slot *s, Slot *nxt) {
+			memcpy(s->link(), &nxt, sizeof(Slot*));
+		}
+
+		// [cur, last) is not carved yet, the slots follow the header
+		struct Chunk {
+			Chunk *next, *next_open;
+			Slot *begin, *cur, *last;
+		};
+
+		Chunk *chunks, *chunks_tail;
+		Chunk *open, *open_tail;
+		Slot *free_head, *free_tail;
+		size_t total, uncarved, free_count;
+
+		NodePool(const NodePool&);
+		NodePool& operator=(const NodePool&);
+
+		static size_t header_size(void) {
+			size_t a = __alignof__(Slot);
+			return (sizeof(Chunk) + a - 1) / a * a;
+		}
+
+		void grow(size_t sz) {
+			char *mem = (char*) ::operator new(header_size() + sz * sizeof(Slot));
+			Chunk *c = (Chunk*) mem;
+			c->begin = c->cur = (Slot*) (mem + header_size());
+			c->last = c->begin + sz;
+			c->next = NULL;
+			if(chunks == NULL) {
+				chunks = c;
+			}else {
+				chunks_tail->next = c;
+			}
+			chunks_tail = c;
+			c->next_open = open;
+			if(open == NULL) open_tail = c;
+			open = c;
+			total += sz;
+			uncarved += sz;
+		}
+
+	public :
+
+		NodePool(void) : chunks(NULL), chunks_tail(NULL), open(NULL), open_tail(NULL),
+			free_head(NULL), free_tail(NULL), total(0), uncarved(0), free_count(0) {}
+		~NodePool(void) {
+			for(Chunk *c = chunks;c != NULL;) {
+				Chunk *nxt = c->next;
+				for(Slot *s = c->begin;s != c->cur;s++) {
+					s->~Slot();
+				}
+				::operator delete((void*) c);
+				c = nxt;
+			}
+		}
+
+		T* allocate(void) {
+			if(free_head != NULL) {
+				Slot *s = free_head;
+				free_head = get_next(s);
+				if(free_head == NULL) free_tail = NULL;
+				free_count--;
+				return &s->value;
+			}
+			while(open != NULL and open->cur == open->last) {
+				open = open->next_open;
+			}
+			if(open == NULL) {
+				open_tail = NULL;
+				grow(total == 0 ? 1 : total);
+			}
+			uncarved--;
+			return &(new (open->cur++) Slot)->value;
+		}
+
+		void release(T *p) {
+			Slot *s = (Slot*) p;
+			set_next(s, free_head);
+			if(free_head == NULL) free_tail = s;
+			free_head = s;
+			free_count++;
+		}
+
+		// make room for sz more nodes without another call to new
+		void reserve(size_t sz) {
+			if(uncarved + free_count < sz) {
+				grow(sz - uncarved - free_count);
+			}
+		}
+
+		// take every node of p in O(1), p is left empty
+		void splice(NodePool &p) {
+			if(&p == this or p.chunks == NULL) return;
+			if(chunks == NULL) {
+				chunks = p.chunks;
+			}else {
+				chunks_tail->next = p.chunks;
+			}
+			chunks_tail = p.chunks_tail;
+			if(p.open != NULL) {
+				if(open == NULL) {
+					open = p.open;
+				}else {
+					open_tail->next_open = p.open;
+				}
+				open_tail = p.open_tail;
+			}
+			if(p.free_head != NULL) {
+				set_next(p.free_tail, free_head);
+				if(free_head == NULL) free_tail = p.free_tail;
+				free_head = p.free_head;
+			}
+			total += p.total;
+			uncarved += p.uncarved;
+			free_count += p.free_count;
+			p.chunks = p.chunks_tail = p.open = p.open_tail = NULL;
+			p.free_head = p.free_tail = NULL;
+			p.total = p.uncarved = p.free_count = 0;
+		}
+
+		// number of nodes owned, in use or free
+		size_t capacity(void) {
+			return total;
+		}
+};
+
+#endif
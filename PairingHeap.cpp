@@ -0,0 +1,146 @@
+/*
+Pairing Heap
+
+Same interface as FibonacciHeap: push returns a handle (the node of
+the element), decreasekey takes the handle, and pop, top and meld
+work the same way. A node has only three pointers and no degree,
+mark or parent, and the code is much shorter.
+
+push, meld and top take O(1), pop takes O(log n) amortized, and
+decreasekey takes o(log n) amortized. pop merges the children of the
+root with the two-pass rule: link them in pairs from left to right,
+then link the pairs from right to left.
+
+Nodes come from a NodePool, pop recycles them and meld takes the
+other heap's nodes without copying, leaving it empty. Joining the two
+pools is O(1), so meld is O(1) in the worst case.
+*/
+
+#ifndef __PAIRING_HEAP__
+
+#define __PAIRING_HEAP__
+
+#include "NodePool.cpp"
+#include <vector>
+
+using namespace std;
+
+template<class Data> class PairingHeap {
+
+	public :
+
+		class iterator {
+
+			public :
+
+				Data key;
+				// left is the previous sibling, or the parent for the first child
+				iterator *left, *right, *left_child;
+		};
+
+		int total_size;
+		iterator *root;
+
+		NodePool<iterator> nodes;
+		vector<iterator*> children;
+
+		bool empty(void) {
+			return root == NULL;
+		}
+
+		int size(void) {
+			return total_size;
+		}
+
+		// the root with the larger key becomes the first child of the other
+		iterator* link(iterator *u, iterator *v) {
+			if(u == NULL) return v;
+			if(v == NULL) return u;
+			if(v->key < u->key) {
+				swap(u, v);
+			}
+			v->left = u;
+			v->right = u->left_child;
+			if(v->right != NULL) v->right->left = v;
+			u->left_child = v;
+			return u;
+		}
+
+		iterator* push(Data new_data) {
+			iterator *new_node = nodes.allocate();
+			new_node->key = new_data;
+			new_node->left = new_node->right = new_node->left_child = NULL;
+			root = link(root, new_node);
+			total_size++;
+			return new_node;
+		}
+
+		// detach the subtree of current and link it with the root
+		void decreasekey(iterator *current, Data new_key) {
+			current->key = new_key;
+			if(current == root) return;
+			if(current->left->left_child == current) {
+				current->left->left_child = current->right;
+			}else {
+				current->left->right = current->right;
+			}
+			if(current->right != NULL) {
+				current->right->left = current->left;
+			}
+			current->left = current->right = NULL;
+			root = link(root, current);
+		}
+
+		void pop(void) {
+
+			if(empty()) {
+				return;
+			}
+
+			children.clear();
+			for(iterator *v = root->left_child;v != NULL;v = v->right) {
+				children.push_back(v);
+			}
+			nodes.release(root);
+			total_size--;
+
+			int cnt = children.size();
+			for(int i = 0;i < cnt;i++) {
+				children[i]->left = children[i]->right = NULL;
+			}
+			// first pass, left to right in pairs
+			int pairs = 0;
+			for(int i = 0;i + 1 < cnt;i += 2) {
+				children[pairs++] = link(children[i], children[i+1]);
+			}
+			if(cnt % 2 == 1) {
+				children[pairs++] = children[cnt-1];
+			}
+			// second pass, right to left
+			root = NULL;
+			for(int i = pairs-1;i >= 0;i--) {
+				root = link(children[i], root);
+			}
+		}
+
+		Data top(void) {
+			if(empty()) {
+				return Data();
+			}
+			return root->key;
+		}
+
+		// move every element of H2 into this heap, H2 becomes empty
+		void meld(PairingHeap<Data> &H2) {
+			if(&H2 == this or H2.empty()) return;
+			nodes.splice(H2.nodes);
+			root = link(root, H2.root);
+			total_size += H2.total_size;
+			H2.root = NULL;
+			H2.total_size = 0;
+		}
+
+		PairingHeap(void) : total_size(0), root(NULL) {}
+};
+
+#endif
@@ -6,9 +6,30 @@ input A1, A2, ..., An
 each query return the minimum number in range i and j
 
 This algorithm requires O(n) precomputation and memmory
-and can answer each query in O(1)
-
-This code is for C++11 or newer version
+and can answer each query in O(1). The O(n) version splits
+the array into blocks of 64 elements, answers in-block queries
+with one bitmask per element and uses a sparse table over the
+minimum of each block.
+
+__RMQ_TYPE_DYNAMIC__ keeps a flat segment tree instead, so
+update() takes O(log n) and each query O(log n).
+
+__RMQ_TYPE_SUCCINCT__ stores only the 2n-bit balanced parentheses
+sequence of the Cartesian tree plus rank/select and minimum excess
+directories, about 5 bits per element, for arrays too large for
+an index table. It is an index only: it keeps no copy of the
+values, so query returns a position in the caller's array,
+operator[] must not be used and update does nothing. The build
+keeps its stack as byte-coded gaps, at most about one byte per
+element (for increasing input) and usually far less.
+
+The comparator is a template parameter (std::less by default)
+so it can be inlined into the inner loops. Callers that need to
+choose it at runtime can use DynamicRMQ, which stores a
+std::function instead.
+
+This code is for C++11 or newer version, large sparse tables are
+built in parallel with std::thread (link with -pthread)
 */
 
 #ifndef __MYLIB__RMQ__
@@ -16,312 +37,364 @@ This code is for C++11 or newer version
 #define __MYLIB__RMQ__
 
 #include "MyMath.cpp"
+#include "BalancedParentheses.cpp"
 #include <vector>
-#include <stack>
+#include <algorithm>
 #include <functional>
+#include <thread>
+#include <cstdint>
 
 #define __RMQ_TYPE_ERROR__ 0
 #define __RMQ_TYPE_N__ 1
 #define __RMQ_TYPE_NLOGN__ 2
 #define __RMQ_TYPE_SLOW__ 3
+#define __RMQ_TYPE_DYNAMIC__ 4
+#define __RMQ_TYPE_SUCCINCT__ 5
 #define __RMQ_DEFAULT_ALGO__ __RMQ_TYPE_NLOGN__
 
+// sparse tables at least this wide are built with one thread per core
+#define __RMQ_PARALLEL_THRESHOLD__ (1 << 20)
+
 using namespace std;
 
-template<class Data> class RMQ {
+template<class Data, class Compare = less<Data> > class RMQ {
 	
 	public:
 
 		int type;
-		mutable function<bool (Data, Data)> cmp;
+		mutable Compare cmp;
 		vector<Data> data; 
 
 	public: 
 
-		RMQ(vector<Data>, int, function<bool (Data, Data)>);
-		RMQ(vector<Data>, function<bool (Data, Data)>);
+		RMQ(const vector<Data>&, int = __RMQ_DEFAULT_ALGO__, const Compare& = Compare());
+		RMQ(const vector<Data>&, const Compare&);
 		RMQ(void);
 
-		int query(int, int);
-		Data operator[](int);
+		int query(int, int) const;
+		const Data& operator[](int) const;
+		void update(int, const Data&);
+
+		static vector<int> answer_offline(const vector<Data>&, const vector< pair<int, int> >&, const Compare& = Compare());
 
 	private:
+
+		template<class, class> friend class MappedRMQ;
 		
 		Data error(void);
 		void initFast1(void);
 		void initFast2(void);
 		void initSlow(void);
+		void initDynamic(void);
+		void initSuccinct(const vector<Data>&);
 
-		int QueryFast1(int, int);
-		int QueryFast2(int, int);
-		int QuerySlow(int, int);
+		int QueryFast1(int, int) const;
+		int QueryFast2(int, int) const;
+		int QuerySlow(int, int) const;
+		int QueryDynamic(int, int) const;
+		int QuerySuccinct(int, int) const;
 
 		// for O(N) algorithm
-		int group(int);
+		static const int K = 64;
+		int group(int) const;
+		int QueryBlock(int, int) const;
 
-		int K;
+		vector<unsigned long long> mask;
 		vector<int> candidate;
-		vector<int> candidate_value;
-		RMQ<Data>* summary;
-
-		class Cluster {
+		vector<Data> candidate_value;
+		vector< vector<int> > block_table;
 
-			public:
-				
-				void BuiltCartesianTree(void);
-				int ComputeHash(void);
-				void ComputeRMQ(void);
-				int query(int, int);
+		// for O(N log N) algorithm
+		void BuildSparseTable(vector< vector<int> >&, const vector<Data>&);
+		void BuildLevel(vector< vector<int> >&, const vector<Data>&, int, int, int) const;
+		int QueryTable(const vector< vector<int> >&, const vector<Data>&, int, int) const;
 
-				mutable function<bool (Data, Data)> cmp;
-				vector<Data> data;
-				vector< vector<int> > rmq;
-				vector<int> list;
+		vector< vector<int> > sparse_table;
 
-				// Euler tour tree
-				vector<int> EulerTour, Height, FirstPosition;
-				
-				int hash;
+		// for updatable algorithm, bottom-up segment tree with leaves at [n, 2n)
+		int better(int, int) const;
+		void UpdateDynamic(int);
 
-				Cluster(vector<Data> _data, function<bool (Data, Data)> _cmp) : data(_data), cmp(_cmp) {}
-		};
+		vector<int> tree;
 
-		vector<Cluster> cluster;
-		vector< vector< vector<int> > > memmory;
-		vector<int> check;
+		// for succinct algorithm, the left-to-right minima stack in
+		// balanced parentheses form, '(' on push and ')' on pop
+		BalancedParentheses bp;
+};
 
-		// for O(N log N) algorithm
-		vector< vector<int> > sparse_table;
+// Type-erased comparator for RMQ with a comparator chosen at runtime
+template<class Data> class DynamicCompare : public function<bool (const Data&, const Data&)> {
+	public:
+		DynamicCompare(void) : function<bool (const Data&, const Data&)>(less<Data>()) {}
+		template<class Function> DynamicCompare(Function f) : function<bool (const Data&, const Data&)>(f) {}
 };
 
+template<class Data> using DynamicRMQ = RMQ<Data, DynamicCompare<Data> >;
+
 // Initialize constructor and helper function
-template <class Data> RMQ<Data>::RMQ(vector<Data> _data, int algorithm = __RMQ_DEFAULT_ALGO__,
-	function<bool (Data, Data)> _cmp = [](Data D1, Data D2) { return D1 < D2; }) {
-	
-	data.assign(_data.begin(), _data.end());
-	cmp = _cmp;
-	type = algorithm;
+template <class Data, class Compare> RMQ<Data, Compare>::RMQ(const vector<Data>& _data, int algorithm,
+	const Compare& _cmp) : type(algorithm), cmp(_cmp),
+	data(algorithm == __RMQ_TYPE_SUCCINCT__ ? vector<Data>() : _data) {
 
 	switch(type) {
 		case __RMQ_TYPE_N__:
 			initFast1();
+			break;
 		case __RMQ_TYPE_NLOGN__:
 			initFast2();
 			break;
 		case __RMQ_TYPE_SLOW__:
 			initSlow();
 			break;
+		case __RMQ_TYPE_DYNAMIC__:
+			initDynamic();
+			break;
+		case __RMQ_TYPE_SUCCINCT__:
+			initSuccinct(_data);
+			break;
 		default:
 			// error
 			break;
 	}
 }
 
-template <class Data> RMQ<Data>::RMQ(vector<Data> _data, 
-	function<bool (Data, Data)> _cmp = [](Data D1, Data D2) { return D1 < D2; }) {
-	RMQ(_data, __RMQ_DEFAULT_ALGO__, _cmp);
-}
+template <class Data, class Compare> RMQ<Data, Compare>::RMQ(const vector<Data>& _data, 
+	const Compare& _cmp) : RMQ(_data, __RMQ_DEFAULT_ALGO__, _cmp) {}
 
-template <class Data> RMQ<Data>::RMQ(void) {
+template <class Data, class Compare> RMQ<Data, Compare>::RMQ(void) {
 	type = __RMQ_TYPE_ERROR__;
 }
 
 // Error function
-template<class Data> Data RMQ<Data>::error(void) {
+template<class Data, class Compare> Data RMQ<Data, Compare>::error(void) {
 	return Data();
 }
 
 // Preprocess functions, the most important and complicated parts of the program
 
-template <class Data> int RMQ<Data>::group(int idx) {
+template <class Data, class Compare> int RMQ<Data, Compare>::group(int idx) const {
 	return idx / K;
 }
 
-template <class Data> void RMQ<Data>::Cluster::BuiltCartesianTree(void) {
-	stack<int> stk, dfs;
-	vector<int> Parent(list.size(), -1);
-	vector< vector<int> > child(list.size(), vector<int>());
-
-	EulerTour.clear();
-	Height.clear();
-	FirstPosition.clear();
-	FirstPosition.resize(list.size(), -1);
-
-	for(int i = 0;i < list.size();i++) {
-		Parent[i] = (stk.empty() ? -1 : stk.top());
-		while(!stk.empty() and cmp(data[list[i]], data[list[stk.top()]]) ) {
-			Parent[stk.top()] = i;
-			stk.pop();
-			Parent[i] = (stk.empty() ? -1 : stk.top());
+// Each block of K = 64 elements keeps, for every position i, the monotone
+// stack of the prefix of the block ending at i as a bitmask. Bit j is set
+// when the j-th element of the block is the minimum of [j, i], so the
+// minimum of [l, i] is the lowest set bit at or above l.
+template <class Data, class Compare> void RMQ<Data, Compare>::initFast1(void) {	
+
+	if(data.empty()) return;
+
+	mask.assign(data.size(), 0);
+	candidate.clear();
+	candidate_value.clear();
+
+	for(int start = 0;start < data.size();start += K) {
+		unsigned long long stk = 0;
+		for(int i = start;i < data.size() and i < start + K;i++) {
+			while(stk != 0) {
+				int top = 63 - __builtin_clzll(stk);
+				if(!cmp(data[i], data[start + top])) break;
+				stk ^= 1ULL << top;
+			}
+			stk |= 1ULL << (i - start);
+			mask[i] = stk;
 		}
-		stk.push(i);
+		candidate.push_back(start + __builtin_ctzll(stk));
+		candidate_value.push_back(data[candidate.back()]);
 	}
-	int root = 0;
-	for(int i = list.size()-1;i >= 0;i--) {
-		if(Parent[i] != -1) {
-			child[Parent[i]].push_back(i);
-		}else {
-			root = i;
-		}
+
+	// summary, sparse table over the minimum of each block
+	block_table.clear();
+	block_table.resize(MyMath::log2((int) candidate.size()) + 1, vector<int>(candidate.size(), 0));
+	for(int j = 0;j < candidate.size();j++) {
+		block_table[0][j] = j;
+	}
+	BuildSparseTable(block_table, candidate_value);
+}
+
+template<class Data, class Compare> void RMQ<Data, Compare>::initFast2(void) {
+	sparse_table.resize(MyMath::log2((int) data.size()) + 1, vector<int>(data.size(), 0));
+	for(int j = 0;j < data.size();j++) {
+		sparse_table[0][j] = j;
 	}
+	BuildSparseTable(sparse_table, data);
+}
 
-	dfs.push(root);
-	while(!dfs.empty()) {
-		int u = dfs.top();
-		EulerTour.push_back(u);
-		Height.push_back(dfs.size());
-		if(FirstPosition[u] == -1) {
-			FirstPosition[u] = (int) EulerTour.size() - 1;
+// fill every level of a sparse table over value whose first level is already set
+// Cells of one level only depend on the previous level, so large tables
+// are split into contiguous ranges built by separate threads, with a join
+// between levels. The ranges start on 64-byte boundaries of the level's
+// own buffer, so two threads never write to the same cache line.
+template<class Data, class Compare> void RMQ<Data, Compare>::BuildSparseTable(vector< vector<int> >& table, const vector<Data>& value) {
+	int n = table.empty() ? 0 : table[0].size();
+	int threads = 1;
+	if(n >= __RMQ_PARALLEL_THRESHOLD__) {
+		threads = max(1, (int) thread::hardware_concurrency());
+	}
+	int chunk = ((n + threads - 1) / threads + 15) / 16 * 16;
+	for(int i = 1;i < table.size();i++) {
+		if(threads == 1) {
+			BuildLevel(table, value, i, 0, n);
+			continue;
 		}
-		if(child[u].size() == 1 and child[u][0] > u) {
-			EulerTour.push_back(-1);
-			Height.push_back(list.size() + 1);
+		// ints before the first cache line boundary of this level
+		int head = (64 - ((uintptr_t) table[i].data() & 63)) % 64 / sizeof(int);
+		vector<thread> worker;
+		for(int from = 0;from < n;) {
+			int to = min(n, (from == 0 ? head : from) + chunk);
+			worker.push_back(thread([this, &table, &value, i, from, to]() {
+				BuildLevel(table, value, i, from, to);
+			}));
+			from = to;
 		}
-		if(child[u].size() == 0) {
-			dfs.pop();
-		}else {
-			dfs.push(child[u].back());
-			child[u].pop_back();
+		for(int t = 0;t < worker.size();t++) {
+			worker[t].join();
 		}
 	}
 }
-template <class Data> int RMQ<Data>::Cluster::ComputeHash(void) {
-	hash = 1 << Height.size();
-	for(int i = 0;i+1 < Height.size();i++) {
-		hash ^= (Height[i] < Height[i+1]) << i;
-	}
-	return hash;
-}
-template <class Data> void RMQ<Data>::Cluster::ComputeRMQ(void) {
-	rmq.clear();
-	rmq.resize(EulerTour.size(), vector<int>(EulerTour.size()));
-	for(int i = 0;i < rmq.size();i++) {
-		for(int j = i;j < rmq[i].size();j++) {
-			if(EulerTour[j] == -1) {
-				rmq[i][j] = (i == j ? -1 : rmq[i][j-1]);
-			}else if(rmq[i][j-1] == -1) {
-				rmq[i][j] = EulerTour[j];
-			}else {
-				rmq[i][j] = (cmp(data[list[EulerTour[j]]], data[list[rmq[i][j-1]]]) ? EulerTour[j] : rmq[i][j-1]);
-			}
-		}
+
+template<class Data, class Compare> void RMQ<Data, Compare>::BuildLevel(vector< vector<int> >& table, const vector<Data>& value,
+	int i, int from, int to) const {
+	const vector<int>& prev = table[i-1];
+	vector<int>& cur = table[i];
+	int last = (int) cur.size() - 1, half = 1 << (i-1);
+	for(int j = from;j < to;j++) {
+		int nxt = min(last, j + half);
+		cur[j] = !cmp(value[prev[nxt]], value[prev[j]]) ? prev[j] : prev[nxt];
 	}
 }
-template <class Data> int RMQ<Data>::Cluster::query(int idx1, int idx2) {
-	if(FirstPosition[idx1] > FirstPosition[idx2]) swap(idx1, idx2);
-	return list[rmq[FirstPosition[idx1]][FirstPosition[idx2]]];
+
+template<class Data, class Compare> void RMQ<Data, Compare>::initSlow(void) {
+	// do nothing
 }
-template <class Data> void RMQ<Data>::initFast1(void) {	
 
-	if(data.empty()) return;
+template<class Data, class Compare> void RMQ<Data, Compare>::initDynamic(void) {
+	int n = data.size();
+	tree.assign(2 * n, 0);
+	for(int i = 0;i < n;i++) {
+		tree[n + i] = i;
+	}
+	for(int i = n-1;i > 0;i--) {
+		tree[i] = better(tree[i << 1], tree[i << 1 | 1]);
+	}
+}
 
-	// set parameter
-	K = MyMath::log2( (int) data.size()) >> 3;
+// index of the smaller element, the left one on ties, -1 is ignored
+template<class Data, class Compare> int RMQ<Data, Compare>::better(int idx1, int idx2) const {
+	if(idx1 == -1) return idx2;
+	if(idx2 == -1) return idx1;
+	return !cmp(data[idx2], data[idx1]) ? idx1 : idx2;
+}
 
-	if(K == 0) {
-		K = 1;
+template<class Data, class Compare> void RMQ<Data, Compare>::UpdateDynamic(int idx) {
+	for(idx = (idx + (int) data.size()) >> 1;idx > 0;idx >>= 1) {
+		tree[idx] = better(tree[idx << 1], tree[idx << 1 | 1]);
 	}
+}
 
-	// summary 
-	for(int i = 0;i < data.size();i++) {
-		int g = group(i);
-		if(i % K == 0) candidate.push_back(i);
-		else if(cmp(data[i], data[candidate[g]])) {
-			candidate[g] = i;
-		}
-	}
-	for(int id : candidate) candidate_value.push_back(data[id]);
-	summary = new RMQ<Data>(candidate_value, __RMQ_TYPE_NLOGN__, cmp);
-
-	// cluster
-	cluster.clear();
-	cluster.resize(group(data.size()-1) + 1, Cluster(data, cmp));
-	memmory.clear();
-	memmory.resize(1 << (K << 2));
-	check.clear();
-	check.resize(memmory.size(), 0);
-	for(int i = 0;i < data.size();i += K) {
-		vector<int> V;
-		for(int j = 0;i+j < data.size() and j < K;j++) {
-			V.push_back(i+j);
+// Element i is pushed as '(' after popping, as ')', every element
+// larger than it. The minimum of [i, j] is the element whose '('
+// follows the last minimum excess between the '(' of i and of j.
+// The stack holds the gaps between its increasing indices in 7-bit
+// groups, most significant first and flagged, so that it can be
+// decoded from the back.
+template<class Data, class Compare> void RMQ<Data, Compare>::initSuccinct(const vector<Data>& value) {
+	bp = BalancedParentheses();
+	bp.reserve(2LL * value.size());
+	vector<unsigned char> gaps;
+	int top = -1, depth = 0;
+	for(int i = 0;i <= value.size();i++) {
+		while(depth > 0 and (i == value.size() or cmp(value[i], value[top]))) {
+			bp.push(false);
+			int gap = 0;
+			for(int shift = 0;;shift += 7) {
+				unsigned char b = gaps.back();
+				gaps.pop_back();
+				gap |= (b & 127) << shift;
+				if(b & 128) break;
+			}
+			top -= gap;
+			depth--;
 		}
-		int g = group(i);
-		cluster[g].list = V;
-		cluster[g].BuiltCartesianTree();
-		if(cluster[g].list.size() == K and check[cluster[g].ComputeHash()]) {
-			check[cluster[g].hash] = 1;
-			cluster[g].rmq = memmory[cluster[g].hash];
-		}else {
-			cluster[g].ComputeRMQ();
-			memmory[cluster[g].hash] = cluster[g].rmq;
+		if(i == value.size()) break;
+		bp.push(true);
+		int gap = i - top, shift = 0;
+		while(gap >> shift >> 7) shift += 7;
+		gaps.push_back(128 | (gap >> shift & 127));
+		for(shift -= 7;shift >= 0;shift -= 7) {
+			gaps.push_back(gap >> shift & 127);
 		}
+		top = i;
+		depth++;
 	}
+	bp.build();
 }
 
-template<class Data> void RMQ<Data>::initFast2(void) {
-	sparse_table.resize(MyMath::log2((int) data.size()) + 1, vector<int>(data.size(), 0));
-	for(int i = 0;i < sparse_table.size();i++) {
-		for(int j = 0;j < sparse_table[i].size();j++) {
-			if(i == 0) {
-				sparse_table[i][j] = j;
-			}else {
-				int nxt = min((int) data.size()-1, j + (1 << (i-1)));
-				sparse_table[i][j] = !cmp(data[sparse_table[i-1][nxt]], data[sparse_table[i-1][j]]) ? sparse_table[i-1][j] : sparse_table[i-1][nxt];
-			} 
-		}
-	}
-}
+// These parts are query functions of each algorithm
 
-template<class Data> void RMQ<Data>::initSlow(void) {
-	// do nothing
+template<class Data, class Compare> int RMQ<Data, Compare>::QueryBlock(int idx1, int idx2) const {
+	unsigned long long m = mask[idx2] & (~0ULL << (idx1 % K));
+	return idx2 - idx2 % K + __builtin_ctzll(m);
 }
 
-// These parts are query functions of each algorithm
-
-template<class Data> int RMQ<Data>::QueryFast1(int idx1, int idx2) {
+template<class Data, class Compare> int RMQ<Data, Compare>::QueryFast1(int idx1, int idx2) const {
 	int g1 = group(idx1), g2 = group(idx2);
-	if(g1 < g2) {
-		int ans = idx1;
-		if(g1 + 1 <= g2 - 1) {
-			int id1 = candidate[summary->query(g1+1, g2-1)];
-			if(cmp(data[id1], data[ans])) {
-				ans = id1;
-			}
-		}
-		int id2 = cluster[g1].query(idx1 % K, K-1);
-		int id3 = cluster[g2].query(0, idx2 % K);
-		if(cmp(data[id2], data[ans])) {
-			ans = id2;
-		}
-		if(cmp(data[id3], data[ans])) {
-			ans = id3;
+	if(g1 == g2) {
+		return QueryBlock(idx1, idx2);
+	}
+	int ans = QueryBlock(idx1, g1 * K + K - 1);
+	if(g1 + 1 <= g2 - 1) {
+		int block = QueryTable(block_table, candidate_value, g1+1, g2-1);
+		if(cmp(candidate_value[block], data[ans])) {
+			ans = candidate[block];
 		}
-		return ans;
-	}else {
-		return cluster[g1].query(idx1 % K, idx2 % K);
 	}
+	int id2 = QueryBlock(g2 * K, idx2);
+	if(cmp(data[id2], data[ans])) {
+		ans = id2;
+	}
+	return ans;
 }
 
-template<class Data> int RMQ<Data>::QueryFast2(int idx1, int idx2) {
+template<class Data, class Compare> int RMQ<Data, Compare>::QueryTable(const vector< vector<int> >& table, const vector<Data>& value, int idx1, int idx2) const {
 	int len = idx2 - idx1 + 1;
 	int x = MyMath::log2(len);
-	int id1 = sparse_table[x][idx1];
-	int id2 = sparse_table[x][idx2 - (1 << x) + 1];
-	return !cmp(data[id2], data[id1]) ? id1 : id2;
+	int id1 = table[x][idx1];
+	int id2 = table[x][idx2 - (1 << x) + 1];
+	return !cmp(value[id2], value[id1]) ? id1 : id2;
+}
+
+template<class Data, class Compare> int RMQ<Data, Compare>::QueryFast2(int idx1, int idx2) const {
+	return QueryTable(sparse_table, data, idx1, idx2);
 }
 
-template<class Data> int RMQ<Data>::QuerySlow(int idx1, int idx2) {
+template<class Data, class Compare> int RMQ<Data, Compare>::QuerySlow(int idx1, int idx2) const {
 	int ans = idx1;
 	for(int i = idx1+1;i <= idx2;i++) {
-		ans = cmp(data[ans], data[i]) ? ans : i; 
+		ans = cmp(data[i], data[ans]) ? i : ans;
 	}
 	return ans;
 }
 
-template<class Data> int RMQ<Data>::query(int idx1, int idx2) {
+template<class Data, class Compare> int RMQ<Data, Compare>::QueryDynamic(int idx1, int idx2) const {
+	int ansl = -1, ansr = -1;
+	for(idx1 += data.size(), idx2 += data.size() + 1;idx1 < idx2;idx1 >>= 1, idx2 >>= 1) {
+		if(idx1 & 1) ansl = better(ansl, tree[idx1++]);
+		if(idx2 & 1) ansr = better(tree[--idx2], ansr);
+	}
+	return better(ansl, ansr);
+}
+
+template<class Data, class Compare> int RMQ<Data, Compare>::QuerySuccinct(int idx1, int idx2) const {
+	long long pos = bp.rmq_excess(bp.select_open(idx1), bp.select_open(idx2) + 1);
+	return bp.rank_open(pos);
+}
+
+template<class Data, class Compare> int RMQ<Data, Compare>::query(int idx1, int idx2) const {
 	if(idx1 > idx2) swap(idx1, idx2);
 	if(idx1 < 0) idx1 = 0;
-	if(idx2 >= data.size()) idx2 = (int) data.size() - 1;
+	int n = (type == __RMQ_TYPE_SUCCINCT__ ? bp.size() / 2 : data.size());
+	if(idx2 >= n) idx2 = n - 1;
 	switch(type) {
 		case __RMQ_TYPE_N__ :
 			return QueryFast1(idx1, idx2);
@@ -329,11 +402,85 @@ template<class Data> int RMQ<Data>::query(int idx1, int idx2) {
 			return QueryFast2(idx1, idx2);
 		case __RMQ_TYPE_SLOW__ :
 			return QuerySlow(idx1, idx2);
+		case __RMQ_TYPE_DYNAMIC__ :
+			return QueryDynamic(idx1, idx2);
+		case __RMQ_TYPE_SUCCINCT__ :
+			return QuerySuccinct(idx1, idx2);
 	}
+	return -1;
 }
 
-template<class Data> Data RMQ<Data>::operator[](int idx) {
+template<class Data, class Compare> const Data& RMQ<Data, Compare>::operator[](int idx) const {
 	return data[idx];
 }
 
+// Change one element. The dynamic algorithm updates in O(log n),
+// the static ones are rebuilt from scratch and the succinct index,
+// which has no values, is left unchanged.
+template<class Data, class Compare> void RMQ<Data, Compare>::update(int idx, const Data& val) {
+	if(idx < 0 or idx >= data.size()) return;
+	data[idx] = val;
+	switch(type) {
+		case __RMQ_TYPE_N__:
+			initFast1();
+			break;
+		case __RMQ_TYPE_NLOGN__:
+			initFast2();
+			break;
+		case __RMQ_TYPE_DYNAMIC__:
+			UpdateDynamic(idx);
+			break;
+	}
+}
+
+// Answer all queries at once without building any table (Arpa's trick).
+// Queries are swept by right endpoint while a monotone stack is kept
+// as a union-find forest, every popped index points to the index that
+// popped it, so the root of i is the minimum of [i, current position].
+template<class Data, class Compare> vector<int> RMQ<Data, Compare>::answer_offline(const vector<Data>& data,
+	const vector< pair<int, int> >& queries, const Compare& cmp) {
+
+	vector<int> ans(queries.size(), -1);
+	if(data.empty()) return ans;
+
+	// bucket queries by right endpoint (counting sort)
+	int n = data.size();
+	vector<int> start(n + 1, 0), order(queries.size()), left(queries.size()), right(queries.size());
+	for(int q = 0;q < queries.size();q++) {
+		int idx1 = queries[q].first, idx2 = queries[q].second;
+		if(idx1 > idx2) swap(idx1, idx2);
+		left[q] = min(max(idx1, 0), n-1);
+		right[q] = min(max(idx2, 0), n-1);
+		start[right[q] + 1]++;
+	}
+	for(int i = 0;i < n;i++) {
+		start[i+1] += start[i];
+	}
+	vector<int> pos(start.begin(), start.end() - 1);
+	for(int q = 0;q < queries.size();q++) {
+		order[pos[right[q]]++] = q;
+	}
+
+	vector<int> parent(n), stk;
+	for(int i = 0;i < n;i++) {
+		parent[i] = i;
+		while(!stk.empty() and cmp(data[i], data[stk.back()])) {
+			parent[stk.back()] = i;
+			stk.pop_back();
+		}
+		stk.push_back(i);
+		for(int k = start[i];k < start[i+1];k++) {
+			int q = order[k];
+			// find with path halving
+			int u = left[q];
+			while(parent[u] != u) {
+				parent[u] = parent[parent[u]];
+				u = parent[u];
+			}
+			ans[q] = u;
+		}
+	}
+	return ans;
+}
+
 #endif
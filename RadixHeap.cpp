@@ -0,0 +1,103 @@
+/*
+Radix Heap
+
+A monotone priority queue of (key, value) pairs with unsigned
+integer keys (32 or 64 bits): a key pushed must not be smaller than
+the last key popped, which is what Dijkstra's algorithm does with
+non-negative weights.
+
+Bucket 0 holds the keys equal to the last popped key and bucket i
+the keys whose highest bit differing from it is bit i-1. When
+bucket 0 is empty, pop takes the first non-empty bucket, makes its
+smallest key the new last key and spreads the bucket over the lower
+ones. A pair only moves to lower buckets, so push is O(1) and pop
+is O(log C) amortized, where C is the largest key difference. The
+buckets are flat vectors that keep their capacity.
+
+There is no handle and no decreasekey, the equivalent is to push
+the pair again with the smaller key and skip the old one when it is
+popped (the key popped for a value is larger than its best key).
+*/
+
+#ifndef __RADIX_HEAP__
+
+#define __RADIX_HEAP__
+
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+template<class Key, class Value> class RadixHeap {
+
+	private :
+
+		static const int bits = sizeof(Key) * 8;
+
+		vector< pair<Key, Value> > bucket[bits + 1];
+		Key last;
+		int total_size;
+
+		// 0 when x is last, otherwise one more than the highest differing bit
+		int bucket_of(Key x) {
+			unsigned long long d = (unsigned long long) (x ^ last);
+			return d == 0 ? 0 : 64 - __builtin_clzll(d);
+		}
+
+		// make bucket 0 non-empty, the heap must not be empty
+		void pull(void) {
+			if(!bucket[0].empty()) return;
+			int i = 1;
+			while(bucket[i].empty()) i++;
+			last = bucket[i][0].first;
+			for(int j = 1;j < bucket[i].size();j++) {
+				if(bucket[i][j].first < last) last = bucket[i][j].first;
+			}
+			for(int j = 0;j < bucket[i].size();j++) {
+				bucket[bucket_of(bucket[i][j].first)].push_back(bucket[i][j]);
+			}
+			bucket[i].clear();
+		}
+
+	public :
+
+		RadixHeap(void) : last(0), total_size(0) {}
+
+		bool empty(void) {
+			return total_size == 0;
+		}
+
+		int size(void) {
+			return total_size;
+		}
+
+		// no key in the heap is smaller, it only grows
+		Key min_key(void) {
+			return last;
+		}
+
+		// key must not be smaller than min_key()
+		void push(Key key, const Value &value) {
+			bucket[bucket_of(key)].push_back(make_pair(key, value));
+			total_size++;
+		}
+
+		pair<Key, Value> top(void) {
+			if(empty()) {
+				return pair<Key, Value>();
+			}
+			pull();
+			return bucket[0].back();
+		}
+
+		void pop(void) {
+			if(empty()) {
+				return;
+			}
+			pull();
+			bucket[0].pop_back();
+			total_size--;
+		}
+};
+
+#endif
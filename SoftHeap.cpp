@@ -8,60 +8,89 @@ with some better advantages. The inventor of this heap claimed that
 this heap can be easily implemented and also attached some source codes
 in the paper result to this implementation.
 
-Overall, the running time of each operations is O(1) except 
-extract-min which can be perform in O(log 1/eps).
+Overall, extract-min takes O(1) amortized time and insert takes
+O(log 1/eps), whatever the number of elements is.
 
 However, Having a better running time has to exchange
-with losing some properties. Some numbers (no more than eps * n) 
+with losing some properties. Some numbers (no more than eps * n)
 are called "corrupted", which their values are changed(increased).
 According to the paper, it proves the optimality of this heap.
 Therefore, there won't be any better heap.
 
-If eps = 2 * n, there is no corrupted number, and
-the performance is as same as fibonacci heap's. 
+Nodes of rank above r = ceil(log2(1/eps)) + 5 share one list of
+items between two children when they are sifted ("car pooling"),
+which is where the corruption comes from. If 1/eps > n there is no
+corrupted number, and the heap is an exact priority queue.
 
-There are lots of applications. For instance, It can be use to 
+extract_min returns an item with the smallest current key, but the
+item keeps its original key, so a corrupted item comes out with a
+key smaller than some keys returned before it. corrupted() counts
+the items extracted that way so far.
+
+Items, nodes and heads come from NodePools and are recycled.
+
+There are lots of applications. For instance, It can be use to
 achieve new running time of finding MST, O(m alpha(n, m)).
 This heap stimulate running time of other problems.
-
-The author, personally, believe that this code is bug-free.
 */
 
 #ifndef SOFT_HEAP
 
 #define SOFT_HEAP
 
-class SoftHeap {
-  private : 
-    const int inf = -1u/2;
+#include "NodePool.cpp"
+#include <cmath>
+#include <climits>
+
+using namespace std;
+
+template<class Data = int> class SoftHeap {
+  private :
+    static const int inf = INT_MAX;
     struct data {
-      int key;
+      Data key;
       data *next;
-      data(int _key) : key(_key), next(NULL) {}
     };
+    // ckey is the current key of every item in the list first..last,
+    // infinite marks a node whose items are all gone
     struct node {
-      int ckey, rank;
+      Data ckey;
+      bool infinite;
+      int rank;
       node *next, *child;
       data *first, *last;
     };
     struct head {
-      head *queue;
+      node *queue;
       head *next, *prev, *suffix_min;
       int rank;
-    }
+    };
     double eps;
+    int r, total_size;
+    long long corrupted_count;
     head *header, *tail;
-  public :
-    int extract_min(void) {
-      node *tmp;
+
+    NodePool<data> datas;
+    NodePool<node> nodes;
+    NodePool<head> heads;
+
+    static bool less_ckey(node *a, node *b) {
+      return !a->infinite and (b->infinite or a->ckey < b->ckey);
     }
-    int pop(void) {
-      return extract_min();
+    node* new_node(void) {
+      node *q = nodes.allocate();
+      q->infinite = false;
+      q->next = q->child = NULL;
+      q->first = q->last = NULL;
+      return q;
+    }
+    head* new_head(void) {
+      return heads.allocate();
     }
     void fix_minlist(head *h) {
       head *tmpmin = (h->next == tail ? h : h->next->suffix_min);
       while(h != header) {
-        if(h->queue->ckey < tmpmin->queue->ckey) {
+        if(less_ckey(h->queue, tmpmin->queue)) {
           tmpmin = h;
         }
         h->suffix_min = tmpmin;
@@ -76,14 +105,14 @@ class SoftHeap {
       }
       prevhead = tohead->prev;
       while(q->rank == tohead->rank) {
-        if(tohead->queue->ckey > q->ckey) {
+        if(less_ckey(q, tohead->queue)) {
           top = q;
           bottom = tohead->queue;
-        }else { 
+        }else {
           top = tohead->queue;
           bottom = q;
         }
-        q = new node();
+        q = new_node();
         q->ckey = top->ckey;
         q->rank = top->rank + 1;
         q->child = bottom;
@@ -92,27 +121,164 @@ class SoftHeap {
         q->last = top->last;
         tohead = tohead->next;
       }
+      // reuse the first head the carry went over, release the others
       if(prevhead == tohead->prev) {
         h = new_head();
       }else {
         h = prevhead->next;
+        for(head *g = h->next;g != tohead;) {
+          head *nxt = g->next;
+          heads.release(g);
+          g = nxt;
+        }
       }
+      h->queue = q;
+      h->rank = q->rank;
       h->prev = prevhead;
       h->next = tohead;
       prevhead->next = tohead->prev = h;
       fix_minlist(h);
     }
-    void insert(int new_key) { 
-      node *p = new node();
-      p->rank = 0, p->ckey = new_key;
-      p->first = p->last = new data(new_key);
+    // refill the item list of v from below, the lists of two
+    // children are joined above rank r
+    node* sift(node *v) {
+      v->first = v->last = NULL;
+      if(v->next == NULL and v->child == NULL) {
+        v->infinite = true;
+        return v;
+      }
+      v->next = sift(v->next);
+      if(less_ckey(v->child, v->next)) {
+        swap(v->child, v->next);
+      }
+      v->first = v->next->first;
+      v->last = v->next->last;
+      v->ckey = v->next->ckey;
+      v->infinite = v->next->infinite;
+      if(v->rank > r and (v->rank % 2 == 1 or v->rank - 1 > v->child->rank)) {
+        v->next = sift(v->next);
+        if(less_ckey(v->child, v->next)) {
+          swap(v->child, v->next);
+        }
+        if(!v->next->infinite and v->next->first != NULL) {
+          v->next->last->next = v->first;
+          v->first = v->next->first;
+          if(v->last == NULL) v->last = v->next->last;
+          v->ckey = v->next->ckey;
+          v->infinite = false;
+        }
+      }
+      // an infinite node has no children, drop it
+      if(v->child->infinite) {
+        if(v->next->infinite) {
+          nodes.release(v->child);
+          nodes.release(v->next);
+          v->child = v->next = NULL;
+        }else {
+          node *old = v->next;
+          nodes.release(v->child);
+          v->child = old->child;
+          v->next = old->next;
+          nodes.release(old);
+        }
+      }
+      return v;
+    }
+    void remove_head(head *h) {
+      h->prev->next = h->next;
+      h->next->prev = h->prev;
+    }
+    // clean up the heads until the minimum one has an item
+    head* find_min(void) {
+      head *h = header->next->suffix_min;
+      while(h->queue->first == NULL) {
+        node *tmp = h->queue;
+        int childcount = 0;
+        while(tmp->next != NULL) {
+          tmp = tmp->next;
+          childcount++;
+        }
+        if(childcount < h->rank / 2) {
+          // the queue is too thin, meld its children back as queues
+          remove_head(h);
+          fix_minlist(h->prev);
+          tmp = h->queue;
+          while(tmp->next != NULL) {
+            node *nxt = tmp->next;
+            meld(tmp->child);
+            nodes.release(tmp);
+            tmp = nxt;
+          }
+          nodes.release(tmp);
+          heads.release(h);
+        }else {
+          h->queue = sift(h->queue);
+          if(h->queue->infinite) {
+            remove_head(h);
+            nodes.release(h->queue);
+            heads.release(h);
+            h = h->prev;
+          }
+          fix_minlist(h);
+        }
+        h = header->next->suffix_min;
+      }
+      return h;
+    }
+  public :
+    int size(void) {
+      return total_size;
+    }
+    bool empty(void) {
+      return total_size == 0;
+    }
+    // number of extracted items whose key was below their current key
+    long long corrupted(void) {
+      return corrupted_count;
+    }
+    int rank_threshold(void) {
+      return r;
+    }
+    Data top(void) {
+      if(empty()) return Data();
+      return find_min()->queue->first->key;
+    }
+    Data extract_min(void) {
+      if(empty()) return Data();
+      node *q = find_min()->queue;
+      data *d = q->first;
+      Data min = d->key;
+      if(min < q->ckey) corrupted_count++;
+      q->first = d->next;
+      if(q->first == NULL) q->last = NULL;
+      datas.release(d);
+      total_size--;
+      return min;
+    }
+    Data pop(void) {
+      return extract_min();
+    }
+    void insert(Data new_key) {
+      data *d = datas.allocate();
+      d->key = new_key;
+      d->next = NULL;
+      node *p = new_node();
+      p->rank = 0;
+      p->ckey = new_key;
+      p->first = p->last = d;
       meld(p);
+      total_size++;
     }
-    
-    SoftHeap(double _eps = 0.5) : eps(_eps) {
-      header = new head();
-      tail = new head();
+    void push(Data new_key) {
+      insert(new_key);
+    }
+
+    SoftHeap(double _eps = 0.5) : eps(_eps), total_size(0), corrupted_count(0) {
+      r = (int) ceil(log2(1.0 / eps)) + 5;
+      header = new_head();
+      tail = new_head();
       tail->rank = inf;
+      tail->queue = NULL;
       header->next = tail;
       tail->prev = header;
     }
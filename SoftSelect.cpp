@@ -0,0 +1,121 @@
+/*
+Soft Select
+
+Selection and approximate sorting with SoftHeap, after Chazelle's
+linear time selection.
+
+select_kth(first, last, k) rearranges [first, last) like
+nth_element: the k-th smallest element (0-based) is moved to
+first + k, the smaller ones before it and the larger ones after it,
+and its value is returned. A round partitions around the median of
+the medians of three groups of three spread over the range. When two
+rounds in a row keep more than 3n/4 elements, the next round takes
+its pivot from a soft heap with eps = 1/3 instead: insert the n
+elements, extract n/3 + 1 of them and take the largest. At least n/3
+elements are not larger than this pivot and, because at most n/3
+elements are corrupted, at least n/3 are not smaller, so that round
+keeps at most 2n/3 elements. Any three rounds in a row shrink the
+range to 3/4, so the running time is O(n) in the worst case with no
+randomness, and on most inputs the soft heap is never built.
+
+approx_sort(first, last, eps) rearranges [first, last) so that every
+element is less than eps * n places away from its place in sorted
+order. The range is split at its median with select_kth until the
+pieces are not longer than eps * n, which takes O(n log 1/eps). The
+pieces themselves are left unsorted. With eps * n < 1 the range is
+sorted.
+
+The soft heap keeps a copy of every element, about 60 bytes each for
+int, so the memory is linear as well.
+*/
+
+#ifndef __MYLIB_SOFT_SELECT__
+
+#define __MYLIB_SOFT_SELECT__
+
+#include "SoftHeap.cpp"
+#include <iterator>
+#include <algorithm>
+
+using namespace std;
+
+namespace SoftSelect {
+
+	template<class Data> Data median3(const Data&, const Data&, const Data&);
+	template<class Iterator> typename iterator_traits<Iterator>::value_type ninther(Iterator, Iterator);
+	template<class Iterator> typename iterator_traits<Iterator>::value_type pivot(Iterator, Iterator);
+	template<class Iterator> typename iterator_traits<Iterator>::value_type select_kth(Iterator, Iterator, long long);
+	template<class Iterator> void approx_sort(Iterator, Iterator, double);
+	template<class Iterator> void split(Iterator, Iterator, long long);
+
+};
+
+template<class Data> Data SoftSelect::median3(const Data &a, const Data &b, const Data &c) {
+	if(b < a) return median3(b, a, c);
+	if(c < b) return c < a ? a : c;
+	return b;
+}
+
+// median of the medians of three groups of three evenly spaced elements
+template<class Iterator> typename iterator_traits<Iterator>::value_type SoftSelect::ninther(Iterator first, Iterator last) {
+	long long d = (last - first) / 9;
+	Iterator a = first, b = first + 3 * d, c = first + 6 * d;
+	return median3(median3(*a, *(a + d), *(a + 2 * d)),
+			median3(*b, *(b + d), *(b + 2 * d)),
+			median3(*c, *(c + d), *(last - 1)));
+}
+
+// an element whose rank is between n/3 and 2n/3
+template<class Iterator> typename iterator_traits<Iterator>::value_type SoftSelect::pivot(Iterator first, Iterator last) {
+	typedef typename iterator_traits<Iterator>::value_type Data;
+	SoftHeap<Data> heap(1.0 / 3);
+	for(Iterator it = first;it != last;it++) {
+		heap.insert(*it);
+	}
+	long long cnt = heap.size() / 3 + 1;
+	Data ans = heap.extract_min();
+	for(long long i = 1;i < cnt;i++) {
+		Data x = heap.extract_min();
+		if(ans < x) ans = x;
+	}
+	return ans;
+}
+
+template<class Iterator> typename iterator_traits<Iterator>::value_type SoftSelect::select_kth(Iterator first, Iterator last, long long k) {
+	typedef typename iterator_traits<Iterator>::value_type Data;
+	int bad = 0;
+	while(last - first > 16) {
+		long long n = last - first;
+		Data x = bad >= 2 ? pivot(first, last) : ninther(first, last);
+		Iterator lt = partition(first, last, [&](const Data &y) { return y < x; });
+		Iterator gt = partition(lt, last, [&](const Data &y) { return !(x < y); });
+		if(k < lt - first) {
+			last = lt;
+		}else if(k < gt - first) {
+			return x;
+		}else {
+			k -= gt - first;
+			first = gt;
+		}
+		// two bad rounds in a row are followed by a soft heap round
+		bad = 4 * (last - first) > 3 * n ? bad + 1 : 0;
+	}
+	sort(first, last);
+	return *(first + k);
+}
+
+// split [first, last) at its median until the pieces have at most block elements
+template<class Iterator> void SoftSelect::split(Iterator first, Iterator last, long long block) {
+	long long n = last - first;
+	if(n <= block) return;
+	select_kth(first, last, n / 2);
+	split(first, first + n / 2, block);
+	split(first + n / 2, last, block);
+}
+
+template<class Iterator> void SoftSelect::approx_sort(Iterator first, Iterator last, double eps) {
+	long long block = (long long) (eps * (last - first));
+	split(first, last, block < 1 ? 1 : block);
+}
+
+#endif
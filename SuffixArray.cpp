@@ -0,0 +1,233 @@
+/*
+Suffix Array
+
+input a string (or a sequence of integers in [0, upper])
+build the sorted order of all suffixes with SA-IS in O(n),
+the LCP array with Kasai's algorithm in O(n), and RMQ over the
+LCP array, so the longest common prefix of any two suffixes
+is answered in O(1).
+
+The text is not kept after construction. Memory is about 20
+bytes per character (suffix array, rank, LCP and the O(n) RMQ).
+
+This code is for C++11 or newer version
+*/
+
+#ifndef __MYLIB__SUFFIX_ARRAY__
+
+#define __MYLIB__SUFFIX_ARRAY__
+
+#include "RMQ.cpp"
+#include <vector>
+#include <string>
+#include <algorithm>
+
+using namespace std;
+
+class SuffixArray {
+
+	public:
+
+		SuffixArray(const string&);
+		SuffixArray(const vector<int>&, int);
+
+		int size(void) const;
+		int operator[](int) const;
+		int rank(int) const;
+		int lcp_array(int) const;
+		int lcp(int, int) const;
+
+	private:
+
+		static int symbol(const string&, int);
+		static int symbol(const vector<int>&, int);
+
+		template<class Sequence> static vector<int> sa_is(const Sequence&, int);
+		template<class Sequence> void build(const Sequence&, int);
+
+		vector<int> SA, Rank;
+
+		// LCP[k] = lcp of the suffixes SA[k] and SA[k+1], kept only inside rmq
+		RMQ<int> rmq;
+};
+
+int SuffixArray::symbol(const string& s, int i) {
+	return (unsigned char) s[i];
+}
+
+int SuffixArray::symbol(const vector<int>& s, int i) {
+	return s[i];
+}
+
+// SA-IS, induced sorting from the sorted LMS suffixes, recursing on the
+// string of LMS substring names when they are not all distinct
+template<class Sequence> vector<int> SuffixArray::sa_is(const Sequence& s, int upper) {
+
+	int n = s.size();
+	if(n == 0) return vector<int>();
+	if(n == 1) return vector<int>(1, 0);
+	if(n == 2) {
+		vector<int> sa(2);
+		sa[0] = (symbol(s, 0) < symbol(s, 1) ? 0 : 1);
+		sa[1] = 1 - sa[0];
+		return sa;
+	}
+
+	vector<int> sa(n);
+	vector<bool> ls(n, false);
+	for(int i = n-2;i >= 0;i--) {
+		ls[i] = (symbol(s, i) == symbol(s, i+1)) ? ls[i+1] : (symbol(s, i) < symbol(s, i+1));
+	}
+
+	// bucket boundaries, L-type suffixes come first in each bucket
+	vector<int> sum_l(upper + 1, 0), sum_s(upper + 1, 0);
+	for(int i = 0;i < n;i++) {
+		if(!ls[i]) {
+			sum_s[symbol(s, i)]++;
+		}else {
+			sum_l[symbol(s, i) + 1]++;
+		}
+	}
+	for(int i = 0;i <= upper;i++) {
+		sum_s[i] += sum_l[i];
+		if(i < upper) sum_l[i+1] += sum_s[i];
+	}
+
+	vector<int> buf(upper + 1);
+	auto induce = [&](const vector<int>& lms) {
+		fill(sa.begin(), sa.end(), -1);
+		copy(sum_s.begin(), sum_s.end(), buf.begin());
+		for(int d : lms) {
+			if(d == n) continue;
+			sa[buf[symbol(s, d)]++] = d;
+		}
+		copy(sum_l.begin(), sum_l.end(), buf.begin());
+		sa[buf[symbol(s, n-1)]++] = n-1;
+		for(int i = 0;i < n;i++) {
+			int v = sa[i];
+			if(v >= 1 and !ls[v-1]) {
+				sa[buf[symbol(s, v-1)]++] = v-1;
+			}
+		}
+		copy(sum_l.begin(), sum_l.end(), buf.begin());
+		for(int i = n-1;i >= 0;i--) {
+			int v = sa[i];
+			if(v >= 1 and ls[v-1]) {
+				sa[--buf[symbol(s, v-1) + 1]] = v-1;
+			}
+		}
+	};
+
+	vector<int> lms_map(n + 1, -1), lms;
+	int m = 0;
+	for(int i = 1;i < n;i++) {
+		if(!ls[i-1] and ls[i]) {
+			lms_map[i] = m++;
+			lms.push_back(i);
+		}
+	}
+
+	induce(lms);
+
+	if(m > 0) {
+		vector<int> sorted_lms;
+		sorted_lms.reserve(m);
+		for(int v : sa) {
+			if(lms_map[v] != -1) sorted_lms.push_back(v);
+		}
+
+		// name the LMS substrings in sorted order
+		vector<int> rec_s(m);
+		int rec_upper = 0;
+		rec_s[lms_map[sorted_lms[0]]] = 0;
+		for(int i = 1;i < m;i++) {
+			int l = sorted_lms[i-1], r = sorted_lms[i];
+			int end_l = (lms_map[l] + 1 < m) ? lms[lms_map[l] + 1] : n;
+			int end_r = (lms_map[r] + 1 < m) ? lms[lms_map[r] + 1] : n;
+			bool same = true;
+			if(end_l - l != end_r - r) {
+				same = false;
+			}else {
+				while(l < end_l and symbol(s, l) == symbol(s, r)) {
+					l++, r++;
+				}
+				if(l == n or symbol(s, l) != symbol(s, r)) same = false;
+			}
+			if(!same) rec_upper++;
+			rec_s[lms_map[sorted_lms[i]]] = rec_upper;
+		}
+
+		vector<int> rec_sa = sa_is(rec_s, rec_upper);
+		for(int i = 0;i < m;i++) {
+			sorted_lms[i] = lms[rec_sa[i]];
+		}
+		induce(sorted_lms);
+	}
+	return sa;
+}
+
+template<class Sequence> void SuffixArray::build(const Sequence& s, int upper) {
+
+	int n = s.size();
+	SA = sa_is(s, upper);
+	Rank.assign(n, 0);
+	for(int i = 0;i < n;i++) {
+		Rank[SA[i]] = i;
+	}
+
+	// Kasai, the lcp drops by at most one from suffix i to suffix i+1
+	vector<int> LCP(max(n-1, 0), 0);
+	for(int i = 0, h = 0;i < n;i++) {
+		if(h > 0) h--;
+		if(Rank[i] == 0) {
+			h = 0;
+			continue;
+		}
+		int j = SA[Rank[i] - 1];
+		while(i + h < n and j + h < n and symbol(s, i+h) == symbol(s, j+h)) {
+			h++;
+		}
+		LCP[Rank[i] - 1] = h;
+	}
+
+	rmq = RMQ<int>(LCP, __RMQ_TYPE_N__);
+}
+
+SuffixArray::SuffixArray(const string& s) {
+	build(s, 255);
+}
+
+// every value of s must be in [0, upper]
+SuffixArray::SuffixArray(const vector<int>& s, int upper) {
+	build(s, upper);
+}
+
+int SuffixArray::size(void) const {
+	return SA.size();
+}
+
+// starting position of the k-th smallest suffix
+int SuffixArray::operator[](int k) const {
+	return SA[k];
+}
+
+// position of suffix i in the sorted order
+int SuffixArray::rank(int i) const {
+	return Rank[i];
+}
+
+// longest common prefix of the k-th and (k+1)-th smallest suffixes
+int SuffixArray::lcp_array(int k) const {
+	return rmq[k];
+}
+
+// longest common prefix of the suffixes starting at i and j
+int SuffixArray::lcp(int i, int j) const {
+	if(i < 0 or j < 0 or i >= size() or j >= size()) return 0;
+	if(i == j) return size() - i;
+	int a = Rank[i], b = Rank[j];
+	if(a > b) swap(a, b);
+	return rmq[rmq.query(a, b-1)];
+}
+
+#endif
@@ -0,0 +1,175 @@
+/*
+VEB Priority Map
+
+A priority queue of (key, value) pairs where keys are integers in
+[0, 2^len). The distinct keys are kept in a van Emde Boas set and
+every key owns a bucket, a doubly linked list of the entries that
+have this key. insert, extract_min, decrease_key and erase touch
+one bucket and change the set only when a bucket becomes empty or
+non-empty, so each takes O(log log U).
+
+insert returns a handle, an index that stays valid until its entry
+is extracted or erased, and is reused after that.
+
+The set can be any tree with the VEB interface (VEB, FlatVEB,
+ArenaVEB). The bucket heads take 4 * 2^len bytes.
+
+This code is written in C++.
+Everyone is free to use this code.
+*/
+
+#ifndef __VEB_PRIORITY_MAP__
+
+#define __VEB_PRIORITY_MAP__
+
+#include "VEB.cpp"
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+template<class Value, class Set = VEB> class VEBPriorityMap {
+
+  private :
+
+    static const int none = -1;
+
+    struct Entry {
+      int key;
+      Value value;
+      int prev, next;
+    };
+
+    Set keys;
+    vector<int> head;
+    vector<Entry> entries;
+    int free_list, total_size;
+
+    void link(int);
+    void unlink(int);
+
+  public :
+
+    typedef int handle;
+
+    // list of functions that are accessible
+    VEBPriorityMap(int);
+
+    int size(void);
+    bool empty(void);
+    int error(void);
+
+    handle insert(int, const Value&);
+    handle top(void);
+    int min_key(void);
+    int key(handle);
+    Value& value(handle);
+    pair<int, Value> extract_min(void);
+    void decrease_key(handle, int);
+    void erase(handle);
+
+};
+
+template<class Value, class Set> VEBPriorityMap<Value, Set>::VEBPriorityMap(int _len) : keys(_len) {
+  head.assign(keys.size(), error());
+  free_list = none;
+  total_size = 0;
+}
+
+// push entry id to the front of the bucket of its key
+template<class Value, class Set> void VEBPriorityMap<Value, Set>::link(int id) {
+  int &first = head[entries[id].key];
+  if(first == none) {
+    keys.insert(entries[id].key);
+  }else {
+    entries[first].prev = id;
+  }
+  entries[id].prev = none;
+  entries[id].next = first;
+  first = id;
+}
+
+template<class Value, class Set> void VEBPriorityMap<Value, Set>::unlink(int id) {
+  Entry &e = entries[id];
+  if(e.prev == none) {
+    head[e.key] = e.next;
+  }else {
+    entries[e.prev].next = e.next;
+  }
+  if(e.next != none) {
+    entries[e.next].prev = e.prev;
+  }
+  if(head[e.key] == none) {
+    keys.erase(e.key);
+  }
+}
+
+template<class Value, class Set> int VEBPriorityMap<Value, Set>::size(void) {
+  return total_size;
+}
+template<class Value, class Set> bool VEBPriorityMap<Value, Set>::empty(void) {
+  return total_size == 0;
+}
+template<class Value, class Set> int VEBPriorityMap<Value, Set>::error(void) {
+  return none;
+}
+
+// out of range keys are rejected with error()
+template<class Value, class Set> typename VEBPriorityMap<Value, Set>::handle
+  VEBPriorityMap<Value, Set>::insert(int key, const Value& value) {
+  if(key < 0 or key >= keys.size()) return error();
+  int id;
+  if(free_list != none) {
+    id = free_list;
+    free_list = entries[id].next;
+  }else {
+    id = entries.size();
+    entries.push_back(Entry());
+  }
+  entries[id].key = key;
+  entries[id].value = value;
+  link(id);
+  total_size++;
+  return id;
+}
+
+// an entry with the smallest key, error() when empty
+template<class Value, class Set> typename VEBPriorityMap<Value, Set>::handle VEBPriorityMap<Value, Set>::top(void) {
+  if(empty()) return error();
+  return head[keys.min()];
+}
+template<class Value, class Set> int VEBPriorityMap<Value, Set>::min_key(void) {
+  if(empty()) return error();
+  return keys.min();
+}
+template<class Value, class Set> int VEBPriorityMap<Value, Set>::key(handle id) {
+  return entries[id].key;
+}
+template<class Value, class Set> Value& VEBPriorityMap<Value, Set>::value(handle id) {
+  return entries[id].value;
+}
+
+template<class Value, class Set> pair<int, Value> VEBPriorityMap<Value, Set>::extract_min(void) {
+  if(empty()) return make_pair(error(), Value());
+  int id = top();
+  pair<int, Value> ans(entries[id].key, entries[id].value);
+  erase(id);
+  return ans;
+}
+
+// move an entry to a new key, a larger key is allowed as well
+template<class Value, class Set> void VEBPriorityMap<Value, Set>::decrease_key(handle id, int key) {
+  if(key < 0 or key >= keys.size() or key == entries[id].key) return;
+  unlink(id);
+  entries[id].key = key;
+  link(id);
+}
+
+template<class Value, class Set> void VEBPriorityMap<Value, Set>::erase(handle id) {
+  unlink(id);
+  entries[id].next = free_list;
+  free_list = id;
+  total_size--;
+}
+
+#endif